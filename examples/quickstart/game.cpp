@@ -56,6 +56,8 @@ struct Character : KTech::Object
 		m_colliders.resize(1);
 		// Make it match the stick figure texture.
 		m_colliders[0].ByTextureCharacter(m_textures[0], 1 /*Can push and be pushed by default.*/);
+		// This object entered the layer before it had colliders, so tell the layer they changed (needed whenever you change the colliders or the position directly while in a layer).
+		UpdateBounds();
 
 		// Register input callback functions to make the character movable by pressing keys.
 		callbackGroup.RegisterCallback( // Move down
@@ -147,6 +149,8 @@ int main()
 	);
 	// The tree was already added to the layer, so adding it again (as follows) will do nothing.
 	tree.EnterLayer(layer.m_id);
+	// Since the tree entered the layer before it had colliders, tell the layer they changed.
+	tree.UpdateBounds();
 
 	// The way textures and colliders are managed might seem unconventional, but it's made this way to simplify changing them later while the game is running.
 
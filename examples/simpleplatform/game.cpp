@@ -85,7 +85,8 @@ struct Character : Object
 
 	virtual void OnOverlap(Point p_dir, size_t p_collider, ID<Object> p_otherObject, size_t p_otherCollider) override
 	{
-		if (engine.memory.objects[p_otherObject]->m_colliders[p_otherCollider].m_type == 2)
+		// `p_otherObject` is null if overlapping the layer's collider grid
+		if (engine.memory.objects.Exists(p_otherObject) && engine.memory.objects[p_otherObject]->m_colliders[p_otherCollider].m_type == 2)
 			box = p_otherObject;
 	}
 
@@ -325,10 +326,14 @@ int main()
 	worldProps.m_textures[1].File("examples/simpleplatform/assets/house.ktecht", Point(18, 14));
 	KTech::Output::Log("<main()> Loading examples/simpleplatform/assets/land.ktecht", RGBColors::blue);
 	worldProps.m_textures[2].File("examples/simpleplatform/assets/land.ktecht", Point(0, 3));
-	worldProps.m_colliders.resize(1);
-	worldProps.m_colliders[0].ByTextureBackground(worldProps.m_textures[2], 0, 1);
 	layer.AddObject(worldProps.m_id);
 
+	// Static terrain goes into the layer's collider grid, so moving objects don't have to process it as another object
+	layer.m_colliderGrid.Resize(viewport);
+	Collider land;
+	land.ByTextureBackground(worldProps.m_textures[2], 0, 1);
+	layer.m_colliderGrid.Stamp(land, worldProps.m_pos + land.m_rPos);
+
 	KTech::Output::Log("<main()> Creating frame", RGBColors::blue);
 	KTech::Object frame(engine, KTech::Point(0, 0), "frame");
 	frame.m_name = "frame";
@@ -346,11 +351,10 @@ int main()
 			"'ESC' to toggle menu."
 		}, RGBAColors::black, RGBAColors::transparent, Point(2, 2))
 		.Transform([](KTech::CellA& cell){ cell.b = RGBA(255, 255, 255, 100); });
-	frame.m_colliders.resize(4);
-	frame.m_colliders[0].Simple(KTech::UPoint(viewport.x, 1), 0, KTech::Point(0, 0));
-	frame.m_colliders[1].Simple(KTech::UPoint(1, viewport.y), 0, KTech::Point(0, 0));
-	frame.m_colliders[2].Simple(KTech::UPoint(viewport.x, 1), 0, KTech::Point(0, viewport.y - 1));
-	frame.m_colliders[3].Simple(KTech::UPoint(1, viewport.y), 0, KTech::Point(viewport.x - 1, 0));
+	layer.m_colliderGrid.Write({ std::string(viewport.x, '#') }, 0, KTech::Point(0, 0));
+	layer.m_colliderGrid.Write(std::vector<std::string>(viewport.y, "#"), 0, KTech::Point(0, 0));
+	layer.m_colliderGrid.Write({ std::string(viewport.x, '#') }, 0, KTech::Point(0, viewport.y - 1));
+	layer.m_colliderGrid.Write(std::vector<std::string>(viewport.y, "#"), 0, KTech::Point(viewport.x - 1, 0));
 	layer.AddObject(frame.m_id);
 
 	KTech::Output::Log("<main()> Creating character", RGBColors::blue);
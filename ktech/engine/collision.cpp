@@ -20,16 +20,23 @@
 
 #include "collision.hpp"
 
+#include "../utility/spatialhash.hpp"
 #include "../basic/point.hpp"
 #include "../basic/upoint.hpp"
+#include "../world/collidergrid.hpp"
 #include "../world/layer.hpp"
 #include "../world/object.hpp"
 #include "../engine/engine.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+#include <utility>
 
-#define OBJECTS engine.memory.objects
-#define LAYERS engine.memory.layers
+// Const, so the lookups don't update cached slots of `ID`s (which would race on `Collision::MoveObjectsParallel()`'s threads)
+#define OBJECTS std::as_const(engine.memory.objects)
+#define LAYERS std::as_const(engine.memory.layers)
 
 /*!
 	@var `Collision::CR`
@@ -70,7 +77,7 @@
 
 	`Object::Move()` calls this function on itself.
 
-	This function processes all `Object`s in the `Layer` to judge whether the moving `Object` can move, or there are blocking `Collider`s. It creates a "movement tree", allowing `Object`s to be pushed one after another in a sequence. This function tries to form an optimal movement tree: it won't stop looking for a way to push all discovered blocking `Object`s, until there are no more `Object`s left to process (or a way was found).
+	This function first tests the `Layer`'s static `ColliderGrid` (`Layer::m_colliderGrid`) with direct cell lookups, and then processes the `Object`s in the `Layer` that are near enough (found using the `Layer`'s `SpatialHash`) to judge whether the moving `Object` can move, or there are blocking `Collider`s. It creates a "movement tree", allowing `Object`s to be pushed one after another in a sequence. This function tries to form an optimal movement tree: it won't stop looking for a way to push all discovered blocking `Object`s, until there are no more `Object`s left to process (or a way was found).
 
 	Based on the final result, it can call back the following virtual `Object` functions (with the appropriate parameters):
 
@@ -84,7 +91,15 @@
 	- `Object::OnOverlapped()` for `Object`s that were overlapped into by another `Object`.
 	- `Object::OnOverlappedExit()` for `Object`s that were left from overlapping by another `Object`.
 
+	Collisions with `ColliderGrid` cells call back only the moving `Object`'s side (the `ColliderGrid` is not an `Object`), with `nullID<Object>` as the other `Object`, and the cell index as the other `Collider`.
+
+	Inactive and hibernating `Object`s (see `Object::m_active` and `Object::IsHibernating()`) don't collide at all: other `Object`s pass through them, and they move without colliding.
+
+	If `Collision::deferEvents` is `true`, these functions are queued instead, and called later by `Collision::CallEvents()`. Either way, if `Object::m_skipUnhandledEvents` is `true`, functions that the `Object` didn't override are skipped after their first call.
+
 	@see `Object`
+	@see `ColliderGrid`
+	@see `Collision::MoveObjects()`
 */
 auto KTech::Collision::MoveObject(const ID<Object>& p_object, Point p_direction) -> bool
 {
@@ -92,55 +107,466 @@ auto KTech::Collision::MoveObject(const ID<Object>& p_object, Point p_direction)
 	std::vector<CollisionData> blockData;
 	std::vector<CollisionData> overlapData;
 	std::vector<CollisionData> exitOverlapData;
+	UpdateTypeMasks();
+	return ResolveMove(p_object, p_direction, pushData, blockData, overlapData, exitOverlapData, deferEvents ? &m_events : nullptr);
+}
+
+/*!
+	@brief Move many `Object`s, one after another.
+
+	The result is the same as calling `Collision::MoveObject()` for each move in the given order (including the order of the called back `Object` functions), but the work buffers are shared between the moves, which saves a lot of allocations when moving crowds of `Object`s (like projectiles) every tick.
+
+	Moves of `Object`s that no longer exist by the time their turn comes (e.g., removed by a call back of an earlier move) are skipped.
+
+	@param moves Pairs of `Object` and the direction to move it in.
+
+	@return Whether each `Object` moved, corresponding to `moves`.
+
+	@see `Collision::MoveObject()`
+	@see `Collision::MoveObjectsParallel()`
+*/
+auto KTech::Collision::MoveObjects(std::span<const std::pair<ID<Object>, Point>> p_moves) -> std::vector<bool>
+{
+	std::vector<bool> results;
+	results.reserve(p_moves.size());
+	std::vector<CollisionData> pushData;
+	std::vector<CollisionData> blockData;
+	std::vector<CollisionData> overlapData;
+	std::vector<CollisionData> exitOverlapData;
+	UpdateTypeMasks();
+	for (const auto& [object, direction] : p_moves)
+	{
+		if (!engine.memory.objects.Exists(object))
+		{
+			results.push_back(false);
+			continue;
+		}
+		pushData.clear();
+		blockData.clear();
+		overlapData.clear();
+		exitOverlapData.clear();
+		results.push_back(ResolveMove(object, direction, pushData, blockData, overlapData, exitOverlapData, deferEvents ? &m_events : nullptr));
+	}
+	return results;
+}
+
+/*!
+	@brief Move many `Object`s, processing each `Layer`'s moves on a separate thread.
+
+	`Object`s collide only with `Object`s from the same `Layer`, so moves in different `Layer`s never affect each other. This function groups `moves` by the `Object`s' `Layer`s, and resolves the groups in parallel on the worker threads kept by `Memory` (up to as many threads as the hardware supports, including the calling thread). Useful for `Map`s with many active `Layer`s (like a `Layer` per room).
+
+	Within each `Layer`, the moves are resolved in the given order, and give the same results as `Collision::MoveObjects()` would with `Collision::deferEvents` set to `true`. However, the `Object` functions can't be called back from the worker threads, so they are called (or queued, if `Collision::deferEvents` is `true`) only after all the moves are done: first the events of the `Layer` that appears first in `moves`, then of the `Layer` that appears second, and so on, each in the order they happened. This order doesn't depend on the threads' timing. As a result, called back functions can't affect the moves of this call (e.g., removing an `Object` before its move), and callbacks of `Object`s that no longer exist by the time they're called are skipped.
+
+	Your `Collider`s, `Collision::colliderTypes` and `Layer`s shouldn't be changed by other threads while this function runs.
+
+	@param moves Pairs of `Object` and the direction to move it in.
+
+	@return Whether each `Object` moved, corresponding to `moves`. Moves of `Object`s that don't exist or aren't in a `Layer` result in `false`.
+
+	@see `Collision::MoveObjects()`
+*/
+auto KTech::Collision::MoveObjectsParallel(std::span<const std::pair<ID<Object>, Point>> p_moves) -> std::vector<bool>
+{
+	// Moves of a single layer, processed by a single thread
+	struct LayerMoves
+	{
+		ID<Layer> layer;
+		std::vector<size_t> moves; // Indices in `p_moves`
+		std::vector<bool> results;
+		std::vector<EventRecord> events;
+	};
+	std::vector<LayerMoves> groups;
+	std::unordered_map<ID<Layer>, size_t> groupIndices;
+	std::vector<bool> results(p_moves.size(), false);
+	UpdateTypeMasks();
+	// Group by layer, in order of first appearance (which is the order the events are merged in).
+	// These lookups are the non-const ones, so the threads find the cached slots of the moves' `ID`s up to date.
+	for (size_t i = 0; i < p_moves.size(); i++)
+	{
+		if (!engine.memory.objects.Exists(p_moves[i].first))
+		{
+			continue;
+		}
+		const ID<Layer>& layer = engine.memory.objects[p_moves[i].first]->m_parentLayer;
+		if (!engine.memory.layers.Exists(layer))
+		{
+			continue;
+		}
+		auto [groupIndex, inserted] = groupIndices.try_emplace(layer, groups.size());
+		if (inserted)
+		{
+			groups.push_back({layer, {}, {}, {}});
+		}
+		groups[groupIndex->second].moves.push_back(i);
+	}
+
+	std::atomic<size_t> nextGroup = 0;
+	// Each share takes groups until none are left, reusing its buffers
+	auto work = [&](size_t)
+	{
+		std::vector<CollisionData> pushData;
+		std::vector<CollisionData> blockData;
+		std::vector<CollisionData> overlapData;
+		std::vector<CollisionData> exitOverlapData;
+		for (size_t groupI = nextGroup++; groupI < groups.size(); groupI = nextGroup++)
+		{
+			LayerMoves& group = groups[groupI];
+			group.results.reserve(group.moves.size());
+			for (size_t moveI : group.moves)
+			{
+				pushData.clear();
+				blockData.clear();
+				overlapData.clear();
+				exitOverlapData.clear();
+				group.results.push_back(ResolveMove(p_moves[moveI].first, p_moves[moveI].second, pushData, blockData, overlapData, exitOverlapData, &group.events));
+			}
+		}
+	};
+	engine.memory.m_workerPool.Run(std::min(groups.size(), engine.memory.m_workerPool.GetThreadsCount()), work);
+
+	for (const LayerMoves& group : groups)
+	{
+		for (size_t i = 0; i < group.moves.size(); i++)
+		{
+			results[group.moves[i]] = group.results[i];
+		}
+	}
+	for (LayerMoves& group : groups)
+	{
+		if (deferEvents)
+		{
+			m_events.insert(m_events.end(), group.events.begin(), group.events.end());
+			continue;
+		}
+		for (const EventRecord& event : group.events)
+		{
+			if (engine.memory.objects.Exists(event.object))
+			{
+				CallEvent(event);
+			}
+		}
+	}
+	return results;
+}
+
+/*!
+	@brief Move an `Object` along a path, one cell at a time, until it's blocked.
+
+	`Collision::MoveObject()` only tests the destination, so a long movement can pass through thin walls. This function instead walks the path to `direction` in steps of at most 1 cell on each axis (spreading diagonal paths evenly), and stops at the first blocked step. Each step is processed like a separate `Collision::MoveObject()` call, including pushing other `Object`s and calling back `Object` functions.
+
+	The nearby `Object`s are looked up once for the whole path rather than for each step (unless a called back function changes the `Layer`'s spatial hash), which makes this cheaper than calling `Collision::MoveObject()` for each cell.
+
+	@param object The `Object` to move.
+	@param direction Total movement.
+
+	@return How far the `Object` got. Equals `direction` if it wasn't blocked.
+
+	@see `Collision::MoveObject()`
+	@see `Object::MoveSwept()`
+*/
+auto KTech::Collision::MoveObjectSwept(const ID<Object>& p_object, Point p_direction) -> Point
+{
+	KTECH_TRACE_SPAN("Collision::MoveObjectSwept");
+	const int32_t steps = std::max(std::abs(p_direction.x), std::abs(p_direction.y));
+	Point moved(0, 0);
+	if (steps == 0)
+	{
+		return moved;
+	}
+
+	const ID<Layer> layerID = OBJECTS[p_object]->m_parentLayer;
+	Layer* layer = LAYERS[layerID];
+	UpdateTypeMasks();
+	PrepareMove(p_object);
+
+	std::vector<ID<Object>> candidates; // Broad phase of the moving object, for the rest of the path
+	bool outdatedCandidates = true;
+	std::vector<CollisionData> pushData;
+	std::vector<CollisionData> blockData;
+	std::vector<CollisionData> overlapData;
+	std::vector<CollisionData> exitOverlapData;
+	for (int32_t step = 1; step <= steps; step++)
+	{
+		if (outdatedCandidates)
+		{
+			candidates.clear();
+			Point start;
+			Point end;
+			if (OBJECTS[p_object]->GetBounds(start, end))
+			{
+				const Point rest = p_direction - moved;
+				layer->m_spatialHash.Query(
+					Point(std::min(start.x, start.x + rest.x), std::min(start.y, start.y + rest.y)),
+					Point(std::max(end.x, end.x + rest.x), std::max(end.y, end.y + rest.y)),
+					candidates
+				);
+			}
+			outdatedCandidates = false;
+		}
+
+		const Point next(p_direction.x * step / steps, p_direction.y * step / steps);
+		const Point stepDirection = next - moved;
+		pushData.clear();
+		blockData.clear();
+		overlapData.clear();
+		exitOverlapData.clear();
+		BuildMovementTree(p_object, stepDirection, pushData, blockData, overlapData, exitOverlapData, &candidates);
+		const bool blocked = !blockData.empty();
+		if (!blocked)
+		{
+			ApplyMovementTree(p_object, stepDirection, pushData);
+			moved = next;
+		}
+		const size_t version = layer->m_spatialHash.GetVersion();
+		RaiseEvents(p_object, stepDirection, pushData, blockData, overlapData, exitOverlapData, deferEvents ? &m_events : nullptr);
+		if (blocked)
+		{
+			break;
+		}
+		// The called back functions might have removed or moved objects
+		if (!engine.memory.objects.Exists(p_object) || OBJECTS[p_object]->m_parentLayer != layerID)
+		{
+			break;
+		}
+		if (layer->m_spatialHash.GetVersion() != version)
+		{
+			OBJECTS[p_object]->CacheBounds();
+			outdatedCandidates = true;
+		}
+	}
+	return moved;
+}
+
+/*!
+	@brief Call the `Object` collision callbacks that were queued while `Collision::deferEvents` was `true`.
+
+	Call this function in your game loop if you set `Collision::deferEvents` to `true`, after all the movement of the tick (for example, after `Memory::CallOnTicks()`). Deferring the callbacks means they can't change the world in the middle of a movement (or of a batch of movements), and that they are all called together, in the order they happened.
+
+	Callbacks of `Object`s that no longer exist are skipped. Callbacks called by this function may move `Object`s, whose callbacks will be queued again, to be called on the next call of this function.
+
+	@see `Collision::deferEvents`
+	@see `Collision::MoveObject()`
+*/
+void KTech::Collision::CallEvents()
+{
+	// Swapped out, so callbacks that move objects queue to a fresh queue
+	std::vector<EventRecord> events;
+	events.swap(m_events);
+	for (const EventRecord& event : events)
+	{
+		if (engine.memory.objects.Exists(event.object))
+		{
+			CallEvent(event);
+		}
+	}
+	// Give the memory back for reuse, if nothing was queued meanwhile
+	if (m_events.empty())
+	{
+		events.clear();
+		m_events.swap(events);
+	}
+}
+
+// Body of `MoveObject()`, with the work buffers (expected empty) given by the caller so they can be reused. Events are queued to `p_events`, or called if it's `nullptr`.
+// Expects `UpdateTypeMasks()` to have been called; doesn't modify anything outside the object's layer otherwise, so layers can be processed in parallel.
+auto KTech::Collision::ResolveMove(const ID<Object>& p_object, Point p_direction,
+	std::vector<CollisionData>& p_pushData,
+	std::vector<CollisionData>& p_blockData,
+	std::vector<CollisionData>& p_overlapData,
+	std::vector<CollisionData>& p_exitOverlapData,
+	std::vector<EventRecord>* p_events) -> bool
+{
+	KTECH_TRACE_SPAN("Collision::ResolveMove");
+	PrepareMove(p_object);
+	BuildMovementTree(p_object, p_direction, p_pushData, p_blockData, p_overlapData, p_exitOverlapData);
+	// Able to move - no blocks at the end (could be that no blocking objects were found or all blocking objects were found to be pushable)
+	if (p_blockData.empty())
+	{
+		ApplyMovementTree(p_object, p_direction, p_pushData);
+	}
+	RaiseEvents(p_object, p_direction, p_pushData, p_blockData, p_overlapData, p_exitOverlapData, p_events);
+	return p_blockData.empty();
+}
 
+// Pick up direct changes to the moving object's position and colliders (other objects are expected to call `Object::UpdateBounds()` after such changes).
+void KTech::Collision::PrepareMove(const ID<Object>& p_object)
+{
+	OBJECTS[p_object]->CacheBounds();
+	LAYERS[OBJECTS[p_object]->m_parentLayer]->UpdateSpatialHash(*OBJECTS[p_object]);
+}
+
+// Expand the movement tree from its root until no more objects in the area can be pushed. `p_rootCandidates`, if given, replaces the broad phase of the root.
+void KTech::Collision::BuildMovementTree(const ID<Object>& p_object, Point p_direction,
+	std::vector<CollisionData>& p_pushData,
+	std::vector<CollisionData>& p_blockData,
+	std::vector<CollisionData>& p_overlapData,
+	std::vector<CollisionData>& p_exitOverlapData,
+	const std::vector<ID<Object>>* p_rootCandidates)
+{
 	// Start root of movement trees
-	ExpandMovementTree(p_object, p_direction, pushData, blockData, overlapData, exitOverlapData);
+	ExpandMovementTree(p_object, p_direction, p_pushData, p_blockData, p_overlapData, p_exitOverlapData, p_rootCandidates);
 	// Expand until no more objects in the area can be pushed
-	for (size_t i = 0; i < pushData.size(); i++)
+	for (size_t i = 0; i < p_pushData.size(); i++)
 	{
-		ExpandMovementTree(pushData[i].passiveObject, p_direction, pushData, blockData, overlapData, exitOverlapData);
+		// Copied, because `p_pushData` may reallocate while expanding
+		const ID<Object> pushedObject = p_pushData[i].passiveObject;
+		ExpandMovementTree(pushedObject, p_direction, p_pushData, p_blockData, p_overlapData, p_exitOverlapData);
 	}
+}
 
-	// Able to move - no blocks at the end (could be that no blocking objects were found or all blocking objects were found to be pushable)
-	if (blockData.empty())
+// Move the root and pushed objects of an unblocked movement tree.
+void KTech::Collision::ApplyMovementTree(const ID<Object>& p_object, Point p_direction, const std::vector<CollisionData>& p_pushData)
+{
+	Layer* layer = LAYERS[OBJECTS[p_object]->m_parentLayer];
+	// Change positions
+	for (const CollisionData& pushDatum : p_pushData)
+	{
+		OBJECTS[pushDatum.passiveObject]->m_pos.x += p_direction.x;
+		OBJECTS[pushDatum.passiveObject]->m_pos.y += p_direction.y;
+	}
+	OBJECTS[p_object]->m_pos.x += p_direction.x;
+	OBJECTS[p_object]->m_pos.y += p_direction.y;
+	// Update the spatial hash before calling events, as they might move objects too
+	for (const CollisionData& pushDatum : p_pushData)
+	{
+		layer->UpdateSpatialHash(*OBJECTS[pushDatum.passiveObject]);
+	}
+	layer->UpdateSpatialHash(*OBJECTS[p_object]);
+}
+
+// Raise the events of a movement tree; the movement events if it wasn't blocked, otherwise the block events.
+void KTech::Collision::RaiseEvents(const ID<Object>& p_object, Point p_direction,
+	const std::vector<CollisionData>& p_pushData,
+	const std::vector<CollisionData>& p_blockData,
+	const std::vector<CollisionData>& p_overlapData,
+	const std::vector<CollisionData>& p_exitOverlapData,
+	std::vector<EventRecord>* p_events)
+{
+	using Event = Object::CollisionEvent;
+	if (p_blockData.empty())
 	{
-		// Change positions
-		for (const CollisionData& pushDatum : pushData)
+		// Push events
+		for (const CollisionData& pushDatum : p_pushData)
 		{
-			OBJECTS[pushDatum.passiveObject]->m_pos.x += p_direction.x;
-			OBJECTS[pushDatum.passiveObject]->m_pos.y += p_direction.y;
+			RaiseEvent(p_events, Event::push, pushDatum.activeObject, p_direction, pushDatum.activeCollider, pushDatum.passiveObject, pushDatum.passiveCollider);
+			RaiseEvent(p_events, Event::pushed, pushDatum.passiveObject, p_direction, pushDatum.passiveCollider, pushDatum.activeObject, pushDatum.activeCollider);
+			RaiseEvent(p_events, Event::move, pushDatum.passiveObject, p_direction, 0, nullID<Object>, 0);
 		}
-		OBJECTS[p_object]->m_pos.x += p_direction.x;
-		OBJECTS[p_object]->m_pos.y += p_direction.y;
-		// Call push events
-		for (const CollisionData& pushDatum : pushData)
+		// Overlap events
+		for (const CollisionData& overlapDatum : p_overlapData)
 		{
-			OBJECTS[pushDatum.activeObject]->OnPush(p_direction, pushDatum.activeCollider, pushDatum.passiveObject, pushDatum.passiveCollider);
-			OBJECTS[pushDatum.passiveObject]->OnPushed(p_direction, pushDatum.passiveCollider, pushDatum.activeObject, pushDatum.activeCollider);
-			OBJECTS[pushDatum.passiveObject]->OnMove(p_direction);
+			RaiseEvent(p_events, Event::overlap, overlapDatum.activeObject, p_direction, overlapDatum.activeCollider, overlapDatum.passiveObject, overlapDatum.passiveCollider);
+			if (overlapDatum.passiveObject != nullID<Object>)
+			{
+				RaiseEvent(p_events, Event::overlapped, overlapDatum.passiveObject, p_direction, overlapDatum.passiveCollider, overlapDatum.activeObject, overlapDatum.activeCollider);
+			}
 		}
-		// Call overlap events
-		for (const CollisionData& overlapDatum : overlapData)
+		// Overlap exit events
+		for (const CollisionData& exitOverlapDatum : p_exitOverlapData)
 		{
-			OBJECTS[overlapDatum.activeObject]->OnOverlap(p_direction, overlapDatum.activeCollider, overlapDatum.passiveObject, overlapDatum.passiveCollider);
-			OBJECTS[overlapDatum.passiveObject]->OnOverlapped(p_direction, overlapDatum.passiveCollider, overlapDatum.activeObject, overlapDatum.activeCollider);
+			RaiseEvent(p_events, Event::overlapExit, exitOverlapDatum.activeObject, p_direction, exitOverlapDatum.activeCollider, exitOverlapDatum.passiveObject, exitOverlapDatum.passiveCollider);
+			if (exitOverlapDatum.passiveObject != nullID<Object>)
+			{
+				RaiseEvent(p_events, Event::overlappedExit, exitOverlapDatum.passiveObject, p_direction, exitOverlapDatum.passiveCollider, exitOverlapDatum.activeObject, exitOverlapDatum.activeCollider);
+			}
 		}
-		// Call overlap exit events
-		for (const CollisionData& exitOverlapDatum : exitOverlapData)
+		RaiseEvent(p_events, Event::move, p_object, p_direction, 0, nullID<Object>, 0);
+		return;
+	}
+	// Unable to move - there are blocking objects.
+	for (const CollisionData& blockDatum : p_blockData)
+	{
+		RaiseEvent(p_events, Event::blocked, blockDatum.activeObject, p_direction, blockDatum.activeCollider, blockDatum.passiveObject, blockDatum.passiveCollider);
+		if (blockDatum.passiveObject != nullID<Object>) // `nullID` means the `ColliderGrid` blocked
 		{
-			OBJECTS[exitOverlapDatum.activeObject]->OnOverlapExit(p_direction, exitOverlapDatum.activeCollider, exitOverlapDatum.passiveObject, exitOverlapDatum.passiveCollider);
-			OBJECTS[exitOverlapDatum.passiveObject]->OnOverlappedExit(p_direction, exitOverlapDatum.passiveCollider, exitOverlapDatum.activeObject, exitOverlapDatum.activeCollider);
+			RaiseEvent(p_events, Event::block, blockDatum.passiveObject, p_direction, blockDatum.passiveCollider, blockDatum.activeObject, blockDatum.activeCollider);
 		}
-		OBJECTS[p_object]->OnMove(p_direction);
-		return true;
 	}
-	// Unable to move - there are blocking objects.
-	for (const CollisionData& blockDatum : blockData)
+}
+
+// Queue an event to `p_events`, or call its callback now if it's `nullptr`. Skipped if the callback isn't overridden.
+void KTech::Collision::RaiseEvent(std::vector<EventRecord>* p_events, Object::CollisionEvent p_event, const ID<Object>& p_object, Point p_direction, size_t p_collider, const ID<Object>& p_otherObject, size_t p_otherCollider)
+{
+	if (!OBJECTS[p_object]->IsHandled(p_event))
 	{
-		OBJECTS[blockDatum.activeObject]->OnBlocked(p_direction, blockDatum.activeCollider, blockDatum.passiveObject, blockDatum.passiveCollider);
-		OBJECTS[blockDatum.passiveObject]->OnBlock(p_direction, blockDatum.passiveCollider, blockDatum.activeObject, blockDatum.activeCollider);
+		return;
+	}
+	if (p_events != nullptr)
+	{
+		p_events->push_back({p_event, p_object, p_otherObject, p_direction, p_collider, p_otherCollider});
+		return;
+	}
+	CallEvent({p_event, p_object, p_otherObject, p_direction, p_collider, p_otherCollider});
+}
+
+// Call the `Object` callback corresponding to an event.
+void KTech::Collision::CallEvent(const EventRecord& p_event)
+{
+	using Event = Object::CollisionEvent;
+	Object* object = OBJECTS[p_event.object];
+	switch (p_event.event)
+	{
+		case Event::move:
+			object->OnMove(p_event.direction);
+			break;
+		case Event::pushed:
+			object->OnPushed(p_event.direction, p_event.collider, p_event.otherObject, p_event.otherCollider);
+			break;
+		case Event::push:
+			object->OnPush(p_event.direction, p_event.collider, p_event.otherObject, p_event.otherCollider);
+			break;
+		case Event::blocked:
+			object->OnBlocked(p_event.direction, p_event.collider, p_event.otherObject, p_event.otherCollider);
+			break;
+		case Event::block:
+			object->OnBlock(p_event.direction, p_event.collider, p_event.otherObject, p_event.otherCollider);
+			break;
+		case Event::overlap:
+			object->OnOverlap(p_event.direction, p_event.collider, p_event.otherObject, p_event.otherCollider);
+			break;
+		case Event::overlapExit:
+			object->OnOverlapExit(p_event.direction, p_event.collider, p_event.otherObject, p_event.otherCollider);
+			break;
+		case Event::overlapped:
+			object->OnOverlapped(p_event.direction, p_event.collider, p_event.otherObject, p_event.otherCollider);
+			break;
+		case Event::overlappedExit:
+			object->OnOverlappedExit(p_event.direction, p_event.collider, p_event.otherObject, p_event.otherCollider);
+			break;
+	}
+}
+
+// Remake the per-type masks, if `colliderTypes` changed since they were last made.
+void KTech::Collision::UpdateTypeMasks()
+{
+	if (colliderTypes == m_cachedColliderTypes)
+	{
+		return;
+	}
+	m_cachedColliderTypes = colliderTypes;
+	m_blockingTypes.fill(0);
+	m_pushingTypes.fill(0);
+	m_overlappingTypes.fill(0);
+	// Go through all possible types, so types that share the last bit are covered too
+	for (size_t type1 = 0; type1 <= std::numeric_limits<uint8_t>::max(); type1++)
+	{
+		for (size_t type2 = 0; type2 <= std::numeric_limits<uint8_t>::max(); type2++)
+		{
+			const uint64_t bit = uint64_t{1} << std::min<size_t>(type2, 63);
+			switch (GetPotentialCollisionResult(type1, type2))
+			{
+				case CR::B:
+					m_blockingTypes[std::min<size_t>(type1, 63)] |= bit;
+					break;
+				case CR::P:
+					m_pushingTypes[std::min<size_t>(type1, 63)] |= bit;
+					break;
+				case CR::O:
+					m_overlappingTypes[std::min<size_t>(type1, 63)] |= bit;
+					break;
+			}
+		}
 	}
-	return false;
 }
 
 auto KTech::Collision::GetPotentialCollisionResult(uint8_t p_type1, uint8_t p_type2) -> CR
@@ -185,19 +611,31 @@ auto KTech::Collision::AreCollidersOverlapping(const Collider& p_collider1, cons
 
 auto KTech::Collision::AreSimpleCollidersOverlapping(const Collider& p_collider1, const Point& p_position1, const Collider& p_collider2, const Point& p_position2) -> bool
 {
-	return p_position1.x < p_position2.x + p_collider2.m_size.x &&
-		p_position1.x + p_collider1.m_size.x > p_position2.x &&
-		p_position1.y < p_position2.y + p_collider2.m_size.y &&
-		p_position1.y + p_collider1.m_size.y > p_position2.y;
+	return p_position1.x < p_position2.x + static_cast<int32_t>(p_collider2.m_size.x) &&
+		p_position1.x + static_cast<int32_t>(p_collider1.m_size.x) > p_position2.x &&
+		p_position1.y < p_position2.y + static_cast<int32_t>(p_collider2.m_size.y) &&
+		p_position1.y + static_cast<int32_t>(p_collider1.m_size.y) > p_position2.y;
 }
 
 auto KTech::Collision::AreSimpleAndComplexCollidersOverlapping(const Collider& p_complex, const Point& p_complexPosition, const Collider& p_simple, const Point& p_simplePosition) -> bool
 {
-	for (size_t y = (p_complexPosition.y < p_simplePosition.y ? p_simplePosition.y - p_complexPosition.y : 0); y < p_complex.m_size.x && p_complexPosition.y + y < p_simplePosition.y + p_simple.m_size.y; y++)
+	// Intersection of both rectangles
+	const int32_t startX = std::max(p_complexPosition.x, p_simplePosition.x);
+	const int32_t startY = std::max(p_complexPosition.y, p_simplePosition.y);
+	const int32_t endX = std::min(p_complexPosition.x + static_cast<int32_t>(p_complex.m_size.x), p_simplePosition.x + static_cast<int32_t>(p_simple.m_size.x));
+	const int32_t endY = std::min(p_complexPosition.y + static_cast<int32_t>(p_complex.m_size.y), p_simplePosition.y + static_cast<int32_t>(p_simple.m_size.y));
+
+	// Any bit of the complex collider within the intersection is an overlap
+	for (int32_t y = startY; y < endY; y++)
 	{
-		for (size_t x = (p_complexPosition.x < p_simplePosition.x ? p_simplePosition.x - p_complexPosition.x : 0); x < p_complex.m_size.x && p_complexPosition.x + x < p_simplePosition.x + p_simple.m_size.x; x++)
+		for (int32_t x = startX; x < endX; x += 64)
 		{
-			if (p_complex(x, y))
+			uint64_t bits = p_complex.GetRowBits(x - p_complexPosition.x, y - p_complexPosition.y);
+			if (endX - x < 64)
+			{
+				bits &= (uint64_t{1} << (endX - x)) - 1; // Cut off cells beyond the intersection
+			}
+			if (bits != 0)
 			{
 				return true;
 			}
@@ -208,55 +646,149 @@ auto KTech::Collision::AreSimpleAndComplexCollidersOverlapping(const Collider& p
 
 auto KTech::Collision::AreComplexCollidersOverlapping(const Collider& p_collider1, const Point& p_position1, const Collider& p_collider2, const Point& p_position2) -> bool
 {
-	// `p_collider1` and `p_collider2` are complex
-	size_t y1 = 0;
-	size_t y2 = 0;
-	// If complex1 is before complex2, then add to y1 so it starts where complex2 starts, and keep y2 0
-	if (p_position1.y < p_position2.y)
+	// Intersection of both rectangles
+	const int32_t startX = std::max(p_position1.x, p_position2.x);
+	const int32_t startY = std::max(p_position1.y, p_position2.y);
+	const int32_t endX = std::min(p_position1.x + static_cast<int32_t>(p_collider1.m_size.x), p_position2.x + static_cast<int32_t>(p_collider2.m_size.x));
+	const int32_t endY = std::min(p_position1.y + static_cast<int32_t>(p_collider1.m_size.y), p_position2.y + static_cast<int32_t>(p_collider2.m_size.y));
+
+	// Align the rows of both colliders to the intersection, and AND them a word at a time
+	for (int32_t y = startY; y < endY; y++)
 	{
-		y1 = p_position2.y - p_position1.y;
+		for (int32_t x = startX; x < endX; x += 64)
+		{
+			uint64_t bits = p_collider1.GetRowBits(x - p_position1.x, y - p_position1.y)
+				& p_collider2.GetRowBits(x - p_position2.x, y - p_position2.y);
+			if (endX - x < 64)
+			{
+				bits &= (uint64_t{1} << (endX - x)) - 1; // Cut off cells beyond the intersection
+			}
+			if (bits != 0)
+			{
+				return true;
+			}
+		}
 	}
-	// Otherwise, if complex2 is before complex1, then add to y2 so it starts where complex1 starts, and keep y1 0
-	else if (p_position2.y < p_position1.y)
+	return false;
+}
+
+void KTech::Collision::CheckColliderGrid(const ID<Object>& p_thisObject, Point p_direction,
+	std::vector<CollisionData>& p_blockData,
+	std::vector<CollisionData>& p_overlapData,
+	std::vector<CollisionData>& p_exitOverlapData)
+{
+	const Object* thisObject = OBJECTS[p_thisObject];
+	const ColliderGrid& grid = LAYERS[thisObject->m_parentLayer]->m_colliderGrid;
+	if (grid.m_c.empty() || !thisObject->m_active || thisObject->m_hibernating)
 	{
-		y2 = p_position1.y - p_position2.y;
+		return;
 	}
 
-	// Iterate with both Ys until one of them reaches the end of their colliders
-	for (; y1 < p_collider1.m_size.y && y2 < p_collider2.m_size.y; y1++, y2++)
+	// Whether a collider's (simple or complex) shape covers a world position, given the collider's world position
+	auto covers = [](const Collider& p_collider, Point p_colliderPosition, Point p_position) -> bool
 	{
-		size_t x1 = 0;
-		size_t x2 = 0;
-		// If complex1 is before complex2, then add to x1 so it starts where complex2 starts, and keep x2 0
-		if (p_position1.x < p_position2.x)
+		const Point local = p_position - p_colliderPosition;
+		if (local.x < 0 || local.x >= static_cast<int32_t>(p_collider.m_size.x)
+			|| local.y < 0 || local.y >= static_cast<int32_t>(p_collider.m_size.y))
 		{
-			x1 = p_position2.x - p_position1.x;
+			return false;
 		}
-		// Otherwise, if complex2 is before complex1, then add to x2 so it starts where complex1 starts, and keep x1 0
-		else if (p_position2.x < p_position1.x)
+		return p_collider.m_simple || p_collider(local.x, local.y);
+	};
+
+	bool blocked = false; // Only the first blocking cell is reported, similarly to a blocking `Object`
+	for (size_t colliderI = 0; colliderI < thisObject->m_colliders.size(); colliderI++)
+	{
+		const Collider& col = thisObject->m_colliders[colliderI];
+		// Skip this one if it is invalid
+		if (!col.m_active || col.m_size.x == 0 || col.m_size.y == 0)
 		{
-			x2 = p_position1.x - p_position2.x;
+			continue;
 		}
 
-		// Iterate with both Xs until one of them reaches the end of their colliders
-		for (; x1 < p_collider1.m_size.x && x2 < p_collider2.m_size.x; x1++, x2++)
+		const Point current = thisObject->m_pos + col.m_rPos;
+		const Point future = current + p_direction;
+		// Only cells within the current and future rectangles of the collider are relevant (the current one for exiting overlaps)
+		Point start(std::max(std::min(current.x, future.x), grid.m_pos.x), std::max(std::min(current.y, future.y), grid.m_pos.y));
+		Point end(
+			std::min(std::max(current.x, future.x) + static_cast<int32_t>(col.m_size.x), grid.m_pos.x + static_cast<int32_t>(grid.m_size.x)),
+			std::min(std::max(current.y, future.y) + static_cast<int32_t>(col.m_size.y), grid.m_pos.y + static_cast<int32_t>(grid.m_size.y))
+		);
+
+		for (Point cell(start.x, start.y); cell.y < end.y; cell.y++)
 		{
-			if (p_collider1(x1, y1) && p_collider2(x2, y2))
+			for (cell.x = start.x; cell.x < end.x; cell.x++)
 			{
-				return true;
+				const size_t cellI = (grid.m_size.x * (cell.y - grid.m_pos.y)) + (cell.x - grid.m_pos.x);
+				if (grid.m_c[cellI] == ColliderGrid::empty)
+				{
+					continue;
+				}
+				const bool futureOverlapState = covers(col, future, cell);
+				if (GetPotentialCollisionResult(col.m_type, grid.m_c[cellI]) == CR::O)
+				{
+					const bool currentOverlapState = covers(col, current, cell);
+					if (!currentOverlapState && futureOverlapState)
+					{
+						p_overlapData.push_back({p_thisObject, nullID<Object>, colliderI, cellI}); // Entered overlap
+					}
+					else if (currentOverlapState && !futureOverlapState)
+					{
+						p_exitOverlapData.push_back({p_thisObject, nullID<Object>, colliderI, cellI}); // Exited overlap
+					}
+				}
+				// Cells can't be pushed, so both block and push results block
+				else if (!blocked && futureOverlapState)
+				{
+					p_blockData.push_back({p_thisObject, nullID<Object>, colliderI, cellI});
+					blocked = true;
+				}
 			}
 		}
 	}
-	return false;
 }
 
 void KTech::Collision::ExpandMovementTree(const ID<Object>& p_thisObject, Point p_direction,
 	std::vector<CollisionData>& p_pushData,
 	std::vector<CollisionData>& p_blockData,
 	std::vector<CollisionData>& p_overlapData,
-	std::vector<CollisionData>& p_exitOverlapData)
+	std::vector<CollisionData>& p_exitOverlapData,
+	const std::vector<ID<Object>>* p_candidates)
 {
-	for (ID<Object>& otherObject : LAYERS[OBJECTS[p_thisObject]->m_parentLayer]->m_objects) // Other objects
+	// Static grid first; direct cell lookups are cheaper than going through the other objects
+	CheckColliderGrid(p_thisObject, p_direction, p_blockData, p_overlapData, p_exitOverlapData);
+
+	// Broad phase: only objects whose bounds touch the area swept by this object can collide with it
+	Point start;
+	Point end;
+	if (!OBJECTS[p_thisObject]->GetBounds(start, end))
+	{
+		return;
+	}
+	const Point sweptStart(std::min(start.x, start.x + p_direction.x), std::min(start.y, start.y + p_direction.y));
+	const Point sweptEnd(std::max(end.x, end.x + p_direction.x), std::max(end.y, end.y + p_direction.y));
+	std::vector<ID<Object>> queriedCandidates;
+	if (p_candidates == nullptr)
+	{
+		LAYERS[OBJECTS[p_thisObject]->m_parentLayer]->m_spatialHash.Query(sweptStart, sweptEnd, queriedCandidates);
+		p_candidates = &queriedCandidates;
+	}
+
+	// Types that this object's colliders can be blocked by, push, or overlap with
+	uint64_t blockingTypes = 0;
+	uint64_t pushingTypes = 0;
+	uint64_t overlappingTypes = 0;
+	for (size_t type = 0; type < 64; type++)
+	{
+		if (OBJECTS[p_thisObject]->m_colliderTypesMask & (uint64_t{1} << type))
+		{
+			blockingTypes |= m_blockingTypes[type];
+			pushingTypes |= m_pushingTypes[type];
+			overlappingTypes |= m_overlappingTypes[type];
+		}
+	}
+
+	for (const ID<Object>& otherObject : *p_candidates) // Other objects
 	{
 		if (otherObject == p_thisObject
 			|| std::ranges::any_of(p_pushData, [&](const CollisionData& pushDatum){ return otherObject == pushDatum.activeObject || otherObject == pushDatum.passiveObject; })) // Filter out pushed/pushing objects (leaving objects outside the movement tree and objects from `blockingObjects`)
@@ -264,12 +796,29 @@ void KTech::Collision::ExpandMovementTree(const ID<Object>& p_thisObject, Point
 			continue;
 		}
 
+		// Reject the whole other object if its bounds are outside the area swept by this object (the spatial hash is only as precise as its cells)
+		Point otherStart;
+		Point otherEnd;
+		if (!OBJECTS[otherObject]->GetBounds(otherStart, otherEnd)
+			|| otherStart.x >= sweptEnd.x || otherEnd.x <= sweptStart.x
+			|| otherStart.y >= sweptEnd.y || otherEnd.y <= sweptStart.y)
+		{
+			continue;
+		}
+		// Which results are possible at all between the colliders of both objects, to stop checking once the result can't change anymore
+		const bool canBlock = (blockingTypes & OBJECTS[otherObject]->m_colliderTypesMask) != 0;
+		const bool canPush = (pushingTypes & OBJECTS[otherObject]->m_colliderTypesMask) != 0;
+		const bool canOverlap = (overlappingTypes & OBJECTS[otherObject]->m_colliderTypesMask) != 0;
+		bool done = false; // Set when no later collider can change the collision result nor cause overlap events
+
 		// *Needed in this scope!
 		CR collisionResult = CR::O; // The collision result between this object and this other object. Default - overlap (nothing, ignored).
 		size_t colliderI; // Collider index
 		size_t otherColliderI; // Other collider index
 		size_t originallyBlockedColliderI; // Used if not found a pushable collider
 		size_t originallyBlockingColliderI; // ^
+		size_t pushingColliderI; // Used if found a pushable collider
+		size_t pushedColliderI; // ^
 
 		for (colliderI = 0; colliderI < OBJECTS[p_thisObject]->m_colliders.size(); colliderI++) // This object's colliders
 		{
@@ -280,6 +829,15 @@ void KTech::Collision::ExpandMovementTree(const ID<Object>& p_thisObject, Point
 			{
 				continue;
 			}
+			// Skip this one if the area it sweeps doesn't reach the other object
+			const Point colStart = OBJECTS[p_thisObject]->m_pos + col.m_rPos;
+			if (std::min(colStart.x, colStart.x + p_direction.x) >= otherEnd.x
+				|| std::max(colStart.x, colStart.x + p_direction.x) + static_cast<int32_t>(col.m_size.x) <= otherStart.x
+				|| std::min(colStart.y, colStart.y + p_direction.y) >= otherEnd.y
+				|| std::max(colStart.y, colStart.y + p_direction.y) + static_cast<int32_t>(col.m_size.y) <= otherStart.y)
+			{
+				continue;
+			}
 
 			for (otherColliderI = 0; otherColliderI < OBJECTS[otherObject]->m_colliders.size(); otherColliderI++) // Other object's colliders
 			{
@@ -301,9 +859,10 @@ void KTech::Collision::ExpandMovementTree(const ID<Object>& p_thisObject, Point
 				// Check enter/exit overlap events
 				if (potentialCollisionResult == CR::O)
 				{
-					// Compare current and future overlapping according to the types of the colliders
-					bool currentOverlapState = AreCollidersOverlapping(col, OBJECTS[p_thisObject]->m_pos + col.m_rPos, otherCol, OBJECTS[otherObject]->m_pos + otherCol.m_rPos);
-					bool futureOverlapState = AreCollidersOverlapping(col, OBJECTS[p_thisObject]->m_pos + col.m_rPos + p_direction, otherCol, OBJECTS[otherObject]->m_pos);
+					// Compare current and future overlapping
+					const Point otherPosition = OBJECTS[otherObject]->m_pos + otherCol.m_rPos;
+					const bool currentOverlapState = AreCollidersOverlapping(col, colStart, otherCol, otherPosition);
+					const bool futureOverlapState = AreCollidersOverlapping(col, colStart + p_direction, otherCol, otherPosition);
 
 					if (!currentOverlapState && futureOverlapState)
 					{
@@ -332,9 +891,23 @@ void KTech::Collision::ExpandMovementTree(const ID<Object>& p_thisObject, Point
 							originallyBlockedColliderI = colliderI;
 							originallyBlockingColliderI = otherColliderI;
 						}
+						else
+						{
+							pushingColliderI = colliderI;
+							pushedColliderI = otherColliderI;
+						}
+						done = !canOverlap && !(collisionResult == CR::B ? canPush : canBlock);
+						if (done)
+						{
+							break;
+						}
 					}
 				}
 			}
+			if (done)
+			{
+				break;
+			}
 		}
 
 		if (collisionResult == CR::B)
@@ -343,7 +916,7 @@ void KTech::Collision::ExpandMovementTree(const ID<Object>& p_thisObject, Point
 		}
 		else if (collisionResult == CR::P)
 		{
-			p_pushData.push_back({p_thisObject, otherObject, otherColliderI, colliderI});
+			p_pushData.push_back({p_thisObject, otherObject, pushingColliderI, pushedColliderI});
 		}
 	}
 }
\ No newline at end of file
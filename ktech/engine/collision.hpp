@@ -23,8 +23,14 @@
 #define KTECH_DEFINITION
 #include "../ktech.hpp"
 #undef KTECH_DEFINITION
+#include "../basic/point.hpp"
+#include "../basic/upoint.hpp"
 #include "../world/object.hpp"
 
+#include <array>
+#include <span>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 /*!
@@ -45,8 +51,14 @@ public:
 		{ CR::B, CR::P, CR::O }, // Pushable - 1
 		{ CR::O, CR::O, CR::O } // Overlapping - 2
 	};
+	bool deferEvents = false; //!< `false` (default): `Object` collision callbacks are called during movement. `true`: they are queued, and called by `Collision::CallEvents()`.
 
 	auto MoveObject(const ID<Object>& object, Point direction) -> bool;
+	auto MoveObjects(std::span<const std::pair<ID<Object>, Point>> moves) -> std::vector<bool>;
+	auto MoveObjectsParallel(std::span<const std::pair<ID<Object>, Point>> moves) -> std::vector<bool>;
+	auto MoveObjectSwept(const ID<Object>& object, Point direction) -> Point;
+
+	void CallEvents();
 
 private:
 	Engine& engine;
@@ -58,20 +70,67 @@ private:
 		size_t passiveCollider;
 	};
 
+	// Compact record of a collision event, for calling its `Object` callback
+	struct EventRecord
+	{
+		Object::CollisionEvent event;
+		ID<Object> object; // The object whose callback to call
+		ID<Object> otherObject;
+		Point direction;
+		size_t collider;
+		size_t otherCollider;
+	};
+
+	std::vector<EventRecord> m_events; // Queued events, if `deferEvents` is `true`
+	std::vector<std::vector<CR>> m_cachedColliderTypes; // Copy of `colliderTypes` that the masks below were made from
+	std::array<uint64_t, 64> m_blockingTypes{}; // For each type (bit), the types resulting in block (types from 63 and on share the last bit)
+	std::array<uint64_t, 64> m_pushingTypes{}; // For each type (bit), the types resulting in push (^)
+	std::array<uint64_t, 64> m_overlappingTypes{}; // For each type (bit), the types resulting in overlap (^)
+
 	inline Collision(Engine& engine)
 		: engine(engine) {};
 
+	void UpdateTypeMasks();
+	void PrepareMove(const ID<Object>& object);
+	auto ResolveMove(const ID<Object>& object, Point direction,
+		std::vector<CollisionData>& pushData,
+		std::vector<CollisionData>& blockData,
+		std::vector<CollisionData>& overlapData,
+		std::vector<CollisionData>& exitOverlapData,
+		std::vector<EventRecord>* events) -> bool;
+	void BuildMovementTree(const ID<Object>& object, Point direction,
+		std::vector<CollisionData>& pushData,
+		std::vector<CollisionData>& blockData,
+		std::vector<CollisionData>& overlapData,
+		std::vector<CollisionData>& exitOverlapData,
+		const std::vector<ID<Object>>* rootCandidates = nullptr);
+	void ApplyMovementTree(const ID<Object>& object, Point direction, const std::vector<CollisionData>& pushData);
+	void RaiseEvent(std::vector<EventRecord>* events, Object::CollisionEvent event, const ID<Object>& object, Point direction, size_t collider, const ID<Object>& otherObject, size_t otherCollider);
+	void CallEvent(const EventRecord& event);
+	void RaiseEvents(const ID<Object>& object, Point direction,
+		const std::vector<CollisionData>& pushData,
+		const std::vector<CollisionData>& blockData,
+		const std::vector<CollisionData>& overlapData,
+		const std::vector<CollisionData>& exitOverlapData,
+		std::vector<EventRecord>* events);
 	auto GetPotentialCollisionResult(uint8_t type1, uint8_t type2) -> CR;
 	// Warning: `position1` and `position2` override `collider1.m_rPos` and `collider2.m_rPos` respectively
 	static auto AreCollidersOverlapping(const Collider& collider1, const Point& position1, const Collider& collider2, const Point& position2) -> bool;
 	static auto AreSimpleCollidersOverlapping(const Collider& collider1, const Point& position1, const Collider& collider2, const Point& position2) -> bool;
 	static auto AreSimpleAndComplexCollidersOverlapping(const Collider& complex, const Point& complexPosition, const Collider& simple, const Point& simplePosition) -> bool;
 	static auto AreComplexCollidersOverlapping(const Collider& collider1, const Point& position1, const Collider& collider2, const Point& position2) -> bool;
+	void CheckColliderGrid(const ID<Object>& thisObject, Point direction,
+		std::vector<CollisionData>& blockData,
+		std::vector<CollisionData>& overlapData,
+		std::vector<CollisionData>& exitOverlapData);
 	void ExpandMovementTree(const ID<Object>& thisObject, Point direction,
 		std::vector<CollisionData>& pushData,
 		std::vector<CollisionData>& blockData,
 		std::vector<CollisionData>& overlapData,
-		std::vector<CollisionData>& exitOverlapData);
+		std::vector<CollisionData>& exitOverlapData,
+		const std::vector<ID<Object>>* candidates = nullptr);
 
 	friend class Engine;
+	friend class Layer;
+	friend class Time;
 };
\ No newline at end of file
@@ -83,7 +83,7 @@
 	@see `Engine::noGameLoopMode`
 */
 KTech::Engine::Engine(UPoint p_imageSize, size_t p_ticksPerSecondLimit, bool p_noGameLoopMode)
-	: noGameLoopMode(p_noGameLoopMode), collision(*this), input(*this, p_noGameLoopMode), output(*this, p_imageSize, p_noGameLoopMode), time(*this, p_ticksPerSecondLimit) {}
+	: noGameLoopMode(p_noGameLoopMode), collision(*this), input(*this, p_noGameLoopMode), memory(*this), output(*this, p_imageSize, p_noGameLoopMode), time(*this, p_ticksPerSecondLimit) {}
 
 /*!
 	@brief Set `Engine::running` to false.
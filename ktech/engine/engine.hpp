@@ -28,6 +28,7 @@
 #include "input/input.hpp"
 #include "memory.hpp"
 #include "output.hpp"
+#include "profiler.hpp"
 #include "time/time.hpp"
 
 /*!
@@ -47,6 +48,7 @@ public:
 	Input input; //!< `Input` engine component.
 	Memory memory; //!< `Memory` engine component.
 	Output output; //!< `Output` engine component.
+	Profiler profiler; //!< `Profiler` engine component.
 	Time time; //!< `Time` engine component.
 
 	Engine(UPoint imageSize, size_t ticksPerSecondLimit = 24, bool noGameLoopMode = false);
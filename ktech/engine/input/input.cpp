@@ -26,7 +26,13 @@
 #include "../engine.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <string_view>
 #ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
 #include <unistd.h>
 #endif
 
@@ -34,7 +40,7 @@
 	@var `Input::input`
 	@brief Input for the last-called callback function.
 
-	Before `Input` calls your function, it will set this string to the exact input which lead to the calling of your function. It's especially useful if you have a function that can be triggered by different inputs, like a ranged callback function (created with `CallbackGroup::RegisterRangedCallback()`): use this variable to evaluate the actual user input.
+	Before `Input` calls your function, it will set this string to the exact input which lead to the calling of your function. It's always a single key: a character (possibly a multi-byte UTF-8 character), an "alt" combination, or an escape sequence (like `Keys::up`), even if it was received together with other keys (like in pasted text) or in parts (like over a slow connection). It's especially useful if you have a function that can be triggered by different inputs, like a ranged callback function (created with `CallbackGroup::RegisterRangedCallback()`): use this variable to evaluate the actual user input.
 */
 /*!
 	@var `Input::quitKey`
@@ -42,6 +48,12 @@
 
 	By default, it's "\x03" (Ctrl+C), which is a common quit key among terminal applications. You may change it, but don't go Vim on your players.
 */
+/*!
+	@var `Input::latency`
+	@brief How long the last input waited before being distributed, in microseconds.
+
+	Measured from when the input loop thread received the input, until `Input::CallCallbacks()` started calling its callback functions (so, mostly the time left until the next tick). Valid in your input callback functions and after `Input::CallCallbacks()`.
+*/
 
 /*!
 	@fn auto KTech::Input::Is(const std::string &stringKey) const -> bool
@@ -158,21 +170,22 @@ auto KTech::Input::Between(char p_start, char p_end) const -> bool
 */
 void KTech::Input::CallCallbacks()
 {
+	const Profiler::Scope profilerScope(engine.profiler, Profiler::Phase::input);
 	Update();
-	// Protect `std::vector m_inputQueue`
-	std::lock_guard<std::mutex> lockGuard(m_inputQueueMutex);
-	// Call callbacks of triggered handlers
-	for (std::string& queuedInput : m_inputQueue)
+	// Call callbacks of triggered handlers, for each queued input
+	InputHeader header{};
+	while (m_inputRing.Read(reinterpret_cast<char*>(&header), sizeof(header)))
 	{
-		input = std::move(queuedInput);
+		// The characters were written along with the header
+		input.resize(header.length);
+		m_inputRing.Read(input.data(), header.length);
+		latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - header.received).count();
 		CallStringHandlers();
 		if (input.length() == 1) // Can be a range handler as well
 		{
 			CallRangeHandlers();
 		}
 	}
-	// All callbacks of triggered handlers were called; clear trigger history
-	m_inputQueue.clear();
 }
 
 void KTech::Input::Update()
@@ -192,7 +205,7 @@ void KTech::Input::Update()
 		)), std::ranges::end(m_groups)
 	);
 	// Delete any `Callback` that is awaiting deletion
-	for (const std::shared_ptr<Handler>& stringHandler : m_stringHandlers)
+	for (const auto& [stringKey, stringHandler] : m_stringHandlers)
 	{
 		stringHandler->RemoveCallbacksSetToBeDeleted();
 	}
@@ -204,86 +217,279 @@ void KTech::Input::Update()
 
 inline void KTech::Input::CallStringHandlers()
 {
-	for (const std::shared_ptr<Handler>& stringHandler : m_stringHandlers) // Input matches handler's string
+	const auto found = m_stringHandlers.find(input);
+	if (found == m_stringHandlers.end()) // No handler for this input
+	{
+		return;
+	}
+	// Call callbacks (a reference to the element, which stays valid even if a callback adds handlers)
+	const std::shared_ptr<Handler>& stringHandler = found->second;
+	for (const std::shared_ptr<Callback>& callback : stringHandler->m_callbacks)
 	{
-		if (input == stringHandler->m_string) // String matches
+		if (callback->status == Callback::Status::enabled && callback->ptr()) // Call if enabled, if returns true update render-on-demand status
 		{
-			// Call callbacks
-			for (const std::shared_ptr<Callback>& callback : stringHandler->m_callbacks)
-			{
-				if (callback->status == Callback::Status::enabled && callback->ptr()) // Call if enabled, if returns true update render-on-demand status
-				{
-					m_changedThisTick = true; // Render-on-demand
-				}
-			}
-			// Break because there shouldn't be a similar handler
-			break;
+			m_changedThisTick = true; // Render-on-demand
+			engine.profiler.AddRenderCause(Profiler::RenderCauseSource::input, input);
 		}
 	}
 }
 
 void KTech::Input::CallRangeHandlers()
 {
-	for (const std::shared_ptr<Handler>& rangeHandler : m_rangeHandlers) // Range handlers
+	for (const std::shared_ptr<Handler>& rangeHandler : m_rangeHandlersByChar[static_cast<unsigned char>(input[0])]) // Range handlers whose range includes the input
 	{
-		if (rangeHandler->m_start <= input[0] && input[0] <= rangeHandler->m_end) // Input matches handler's range
+		for (const std::shared_ptr<Callback>& callback: rangeHandler->m_callbacks) // Call callbacks
 		{
-			for (const std::shared_ptr<Callback>& callback: rangeHandler->m_callbacks) // Call callbacks
+			if (callback->status == Callback::Status::enabled && callback->ptr()) // Call if enabled, if returns true update render-on-demand status
 			{
-				if (callback->status == Callback::Status::enabled && callback->ptr()) // Call if enabled, if returns true update render-on-demand status
-				{
-					m_changedThisTick = true; // Render-on-demand
-				}
+				m_changedThisTick = true; // Render-on-demand
+				engine.profiler.AddRenderCause(Profiler::RenderCauseSource::input, input);
 			}
 		}
 	}
 }
 
-void KTech::Input::Get()
+// Read from stdin, split what was read into inputs and queue them. Returns `false` if the input loop should stop (quit key, no more input, or `~Input()`).
+auto KTech::Input::Get() -> bool
 {
-	constexpr int maxCharacters = 7;
+	// An incomplete escape sequence (or a lone escape key) from the previous read waits for the rest only for a short time
+	if (m_unqueuedLength > 0 && !WaitForStdin(escapeTimeout))
+	{
+		const bool quit = QueueToken(m_readBuffer.data(), m_unqueuedLength);
+		m_unqueuedLength = 0;
+		return !quit;
+	}
 #ifdef _WIN32
 	// Read
-	TCHAR tcharBuf[7];
-	memset(tcharBuf, 0, sizeof(tcharBuf));
-	DWORD nReadCharacters = 0;
-	ReadConsole(m_stdinHandle, tcharBuf, sizeof(tcharBuf) / sizeof(TCHAR), &nReadCharacters, NULL);
+	std::array<TCHAR, readBufferSize> tcharBuf;
+	DWORD length = 0;
+	if (!ReadConsole(m_stdinHandle, tcharBuf.data(), readBufferSize - m_unqueuedLength, &length, NULL))
+	{
+		return false;
+	}
 	// Convert `TCHAR` string to `char` string
-	std::string charBuf(nReadCharacters, '\0');
-	for (size_t i = 0; i < nReadCharacters; i++)
+	for (size_t i = 0; i < length; i++)
 	{
-		charBuf[i] = tcharBuf[i];
+		m_readBuffer[m_unqueuedLength + i] = tcharBuf[i];
 	}
-	// Protect `std::vector m_inputQueue`
-	std::lock_guard<std::mutex> lockGuard(m_inputQueueMutex);
-	// Move to input history
-	m_inputQueue.push_back(std::move(charBuf));
 #else
+	// Wait first, rather than block in `read()`, so `~Input()` can wake this
+	if (!WaitForStdin(-1))
+	{
+		return false;
+	}
 	// Read
-	std::string buf(maxCharacters, '\0');
-	buf.resize(read(0, buf.data(), buf.size()));
-	// Protect `std::vector m_inputQueue`
-	std::lock_guard<std::mutex> lockGuard(m_inputQueueMutex);
-	// Move to input history
-	m_inputQueue.push_back(std::move(buf));
+	const ssize_t length = read(0, m_readBuffer.data() + m_unqueuedLength, readBufferSize - m_unqueuedLength);
+	if (length <= 0)
+	{
+		// Try again if interrupted by a signal; otherwise stdin ended or failed, and there won't be more input
+		return length == -1 && errno == EINTR;
+	}
+#endif
+	// Split into inputs; a burst (like pasted text) or a slow connection can make a read contain several inputs, or only part of one
+	const size_t end = m_unqueuedLength + length;
+	size_t start = 0;
+	while (start < end)
+	{
+		const size_t tokenLength = GetTokenLength(m_readBuffer.data() + start, end - start);
+		if (tokenLength == 0)
+		{
+			break;
+		}
+		if (QueueToken(m_readBuffer.data() + start, tokenLength))
+		{
+			return false;
+		}
+		start += tokenLength;
+	}
+	// Keep the incomplete input for the next read
+	m_unqueuedLength = end - start;
+	std::memmove(m_readBuffer.data(), m_readBuffer.data() + start, m_unqueuedLength);
+	return true;
+}
+
+// Queue a single input, and check whether it's the quit key. Returns `true` if it is.
+auto KTech::Input::QueueToken(const char* p_token, size_t p_length) -> bool
+{
+	Queue(p_token, p_length);
+	if (std::string_view(p_token, p_length) == quitKey)
+	{
+		// Quit
+		engine.running = false;
+		return true;
+	}
+	return false;
+}
+
+// Length of the input at the start of `p_bytes`: a key, an escape sequence (CSI or SS3), an "alt" combination, or a UTF-8 character. 0 if it may be incomplete.
+auto KTech::Input::GetTokenLength(const char* p_bytes, size_t p_size) -> size_t
+{
+	const auto first = static_cast<unsigned char>(p_bytes[0]);
+	if (first == '\x1b')
+	{
+		if (p_size < 2)
+		{
+			return 0;
+		}
+		if (p_bytes[1] == '[')
+		{
+			// CSI: parameter bytes (0x30-0x3F) and intermediate bytes (0x20-0x2F), ended by a final byte (0x40-0x7E)
+			for (size_t i = 2; i < p_size; i++)
+			{
+				const auto byte = static_cast<unsigned char>(p_bytes[i]);
+				if (0x40 <= byte && byte <= 0x7e)
+				{
+					return i + 1;
+				}
+				if (byte < 0x20 || 0x3f < byte)
+				{
+					// Malformed; end it before the unexpected byte
+					return i;
+				}
+			}
+			// Avoid waiting forever for a sequence that won't end
+			return p_size >= maxInputLength ? maxInputLength : 0;
+		}
+		if (p_bytes[1] == 'O')
+		{
+			// SS3: a single final byte
+			return p_size < 3 ? 0 : 3;
+		}
+		if (p_bytes[1] == '\x1b')
+		{
+			// "Alt+Escape", unless it's an escape key followed by an escape sequence
+			if (p_size < 3)
+			{
+				return 0;
+			}
+			return p_bytes[2] == '[' || p_bytes[2] == 'O' ? 1 : 2;
+		}
+		// "Alt" and a key
+		return 2;
+	}
+	if (first >= 0xc0 && first < 0xf8)
+	{
+		// UTF-8 leading byte, followed by continuation bytes
+		const size_t length = first >= 0xf0 ? 4 : (first >= 0xe0 ? 3 : 2);
+		for (size_t i = 1; i < length; i++)
+		{
+			if (i == p_size)
+			{
+				return 0;
+			}
+			if ((static_cast<unsigned char>(p_bytes[i]) & 0xc0) != 0x80)
+			{
+				// Malformed; end it before the unexpected byte
+				return i;
+			}
+		}
+		return length;
+	}
+	return 1;
+}
+
+// Wait until stdin has something to read, until the timeout (milliseconds; negative means none) passes, or until `~Input()` stops the input loop. Returns `true` if stdin has something to read (and the input loop wasn't stopped).
+auto KTech::Input::WaitForStdin(int p_timeout) -> bool
+{
+#ifdef _WIN32
+	return WaitForSingleObject(m_stdinHandle, p_timeout) == WAIT_OBJECT_0;
+#else
+	std::array<pollfd, 2> polls{pollfd{0, POLLIN, 0}, pollfd{m_stopPipe[0], POLLIN, 0}}; // `poll()` ignores the negative fd if the stop pipe wasn't created
+	int result = 0;
+	do
+	{
+		result = poll(polls.data(), polls.size(), p_timeout);
+	}
+	while (result == -1 && errno == EINTR);
+	return result != 0 && polls[1].revents == 0;
+#endif
+}
+
+// Pass an input to `CallCallbacks()` (without allocating memory). Called only by the input loop thread.
+void KTech::Input::Queue(const char* p_input, size_t p_length)
+{
+	p_length = std::min(p_length, maxInputLength);
+	std::array<char, sizeof(InputHeader) + maxInputLength> record{};
+	const InputHeader header{std::chrono::steady_clock::now(), static_cast<uint8_t>(p_length)};
+	std::memcpy(record.data(), &header, sizeof(header));
+	std::memcpy(record.data() + sizeof(header), p_input, p_length);
+	// The ring only fills up if `CallCallbacks()` isn't called for a long time (e.g., the game loop is stuck, or paused in a debugger).
+	// There is nothing else for this thread to do meanwhile, so it polls for room every millisecond, until there is room or the engine stops.
+	while (!m_inputRing.Write(record.data(), sizeof(header) + p_length))
+	{
+		if (!engine.running || m_stopping)
+		{
+			return;
+		}
+		SignalQueued(); // In case `WaitForInput()` waits for the inputs queued so far
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+#ifndef _WIN32
+	m_queuedUnsignaled = true;
+#endif
+}
+
+// Wake `WaitForInput()` if it waits and inputs were queued since the last call. Called by the input loop thread once per read, rather than per input.
+void KTech::Input::SignalQueued()
+{
+#ifndef _WIN32
+	if (!m_queuedUnsignaled)
+	{
+		return;
+	}
+	m_queuedUnsignaled = false;
+	// Pairs with the fence in `WaitForInput()`: either it sees the queued inputs, or this sees it waiting
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_waitingForInput.load(std::memory_order_relaxed))
+	{
+		// If the pipe is full, `WaitForInput()` is awake anyway
+		const char byte = 0;
+		static_cast<void>(write(m_inputPipe[1], &byte, 1));
+	}
 #endif
 }
 
 void KTech::Input::Loop()
 {
-	while (engine.running)
+	bool reading = true;
+	while (engine.running && reading)
+	{
+		reading = Get();
+		SignalQueued();
+	}
+	m_inputLoopEnded = true;
+}
+
+// Wait until the input loop receives an input, or until the timeout (microseconds; negative means none) passes. Returns immediately if there are queued inputs that `CallCallbacks()` didn't take yet.
+void KTech::Input::WaitForInput(long p_timeout)
+{
+#ifdef _WIN32
+	static_cast<void>(p_timeout); // Not implemented; don't wait
+#else
+	if (m_inputPipe[0] == -1)
 	{
-		// Get input
-		Get();
-		// Protect `std::vector m_inputQueue`
-		std::lock_guard<std::mutex> lockGuard(m_inputQueueMutex);
-		if (m_inputQueue[m_inputQueue.size() - 1] == quitKey)
+		// No input loop (no-game-loop mode)
+		if (p_timeout > 0)
 		{
-			// Quit
-			engine.running = false;
-			break;
+			std::this_thread::sleep_for(std::chrono::microseconds(p_timeout));
 		}
+		return;
+	}
+	// The input loop only signals the pipe while this waits (so it doesn't write to it per input when idle mode isn't used)
+	m_waitingForInput.store(true, std::memory_order_relaxed);
+	// Pairs with the fence in `SignalQueued()`
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_inputRing.IsEmpty())
+	{
+		pollfd pipe{m_inputPipe[0], POLLIN, 0};
+		// Round up to whole milliseconds, so the timeout isn't woken up from too early
+		static_cast<void>(poll(&pipe, 1, p_timeout < 0 ? -1 : static_cast<int>((p_timeout + 999) / 1000)));
 	}
+	m_waitingForInput.store(false, std::memory_order_relaxed);
+	// Empty the pipe, including signals that came too late to matter
+	std::array<char, 64> buffer{};
+	while (read(m_inputPipe[0], buffer.data(), buffer.size()) > 0) {}
+#endif
 }
 
 KTech::Input::Input(Engine& p_engine, bool p_noGameLoopMode)
@@ -322,6 +528,17 @@ KTech::Input::Input(Engine& p_engine, bool p_noGameLoopMode)
 	terminalAttributes.c_cc[VMIN] = 1; // Blocking read
 	terminalAttributes.c_cc[VTIME] = 0;
 	tcsetattr(0, TCSANOW, &terminalAttributes);
+	// Non-blocking, so neither of the threads can get stuck on it
+	if (pipe(m_inputPipe) == 0)
+	{
+		fcntl(m_inputPipe[0], F_SETFL, fcntl(m_inputPipe[0], F_GETFL) | O_NONBLOCK);
+		fcntl(m_inputPipe[1], F_SETFL, fcntl(m_inputPipe[1], F_GETFL) | O_NONBLOCK);
+	}
+	if (pipe(m_stopPipe) != 0)
+	{
+		m_stopPipe[0] = -1;
+		m_stopPipe[1] = -1;
+	}
 #endif
 
 	// START the input loop thread
@@ -342,8 +559,36 @@ KTech::Input::~Input()
 	tcsetattr(0, TCSANOW, &m_oldTerminalAttributes);
 #endif
 
+#ifndef _WIN32
+	if (m_stopPipe[1] != -1)
+	{
+		// Wake the input loop thread (whether it waits for stdin or for room in `m_inputRing`), then join it, after which nothing uses the pipes
+		m_stopping = true;
+		const char byte = 0;
+		static_cast<void>(write(m_stopPipe[1], &byte, 1));
+		m_inputLoop.join();
+		for (int fd : {m_inputPipe[0], m_inputPipe[1], m_stopPipe[0], m_stopPipe[1]})
+		{
+			if (fd != -1)
+			{
+				close(fd);
+			}
+		}
+		return;
+	}
+#endif
+	if (m_inputLoopEnded)
+	{
+		m_inputLoop.join();
+#ifndef _WIN32
+		close(m_inputPipe[0]);
+		close(m_inputPipe[1]);
+#endif
+		return;
+	}
 	// Detach so in the case that the game quit regardless of player input,
 	// the input loop thread would end.
+	// (Only if it can't be woken; the pipes are then left open, since the thread may still use them)
 	m_inputLoop.detach();
 }
 
@@ -353,20 +598,15 @@ auto KTech::Input::CreateCallback(const std::string& p_stringKey, const std::fun
 	{
 		return nullptr;
 	}
-	// If a handler already exists for this input, add the callback to the calls vector
-	for (const std::shared_ptr<Handler>& stringHandler : m_stringHandlers)
+	// Find the handler of this input, or create a new one if there isn't
+	std::shared_ptr<Handler>& stringHandler = m_stringHandlers[p_stringKey];
+	if (stringHandler == nullptr)
 	{
-		if (stringHandler->m_string == p_stringKey)
-		{
-			stringHandler->m_callbacks.push_back(std::make_shared<Callback>(p_callback, stringHandler));
-			return stringHandler->m_callbacks[stringHandler->m_callbacks.size() - 1]; // Last callback
-		}
+		stringHandler = std::make_shared<Handler>(p_stringKey);
 	}
-	// Otherwise, create a new handler
-	m_stringHandlers.push_back(std::make_shared<Handler>(p_stringKey));
 	// And add a callback to it
-	m_stringHandlers[m_stringHandlers.size() - 1]->m_callbacks.push_back(std::make_shared<Callback>(p_callback, m_stringHandlers[m_stringHandlers.size() - 1]));
-	return m_stringHandlers[m_stringHandlers.size() - 1]->m_callbacks[m_stringHandlers[m_stringHandlers.size() - 1]->m_callbacks.size() - 1]; // Last callback of last handler
+	stringHandler->m_callbacks.push_back(std::make_shared<Callback>(p_callback, stringHandler));
+	return stringHandler->m_callbacks[stringHandler->m_callbacks.size() - 1]; // Last callback
 }
 
 auto KTech::Input::CrateRangedCallback(char p_start, char p_end, const std::function<bool()>& p_callback) -> std::shared_ptr<Callback>
@@ -375,8 +615,9 @@ auto KTech::Input::CrateRangedCallback(char p_start, char p_end, const std::func
 	{
 		return nullptr;
 	}
-	// If a handler already exists for this input, add the callback to the calls vector
-	for (const std::shared_ptr<Handler>& rangeHandler : m_rangeHandlers)
+	// If a handler already exists for this range, it's among the handlers of the range's start, so add the callback to it
+	std::vector<std::shared_ptr<Handler>>& startHandlers = m_rangeHandlersByChar[static_cast<unsigned char>(p_start)];
+	for (const std::shared_ptr<Handler>& rangeHandler : startHandlers)
 	{
 		if (rangeHandler->m_start == p_start && rangeHandler->m_end == p_end)
 		{
@@ -385,10 +626,16 @@ auto KTech::Input::CrateRangedCallback(char p_start, char p_end, const std::func
 		}
 	}
 	// Otherwise, create a new handler
-	m_rangeHandlers.push_back(std::make_shared<Handler>(p_start, p_end));
+	const std::shared_ptr<Handler> rangeHandler = std::make_shared<Handler>(p_start, p_end);
+	m_rangeHandlers.push_back(rangeHandler);
+	// Add it to the characters of its range (compared as `char`, like `Input::Between()`)
+	for (int character = p_start; character <= p_end; character++)
+	{
+		m_rangeHandlersByChar[static_cast<unsigned char>(character)].push_back(rangeHandler);
+	}
 	// And add a callback to it
-	m_rangeHandlers[m_rangeHandlers.size() - 1]->m_callbacks.push_back(std::make_shared<Callback>(p_callback, m_rangeHandlers[m_rangeHandlers.size() - 1]));
-	return m_rangeHandlers[m_rangeHandlers.size() - 1]->m_callbacks[m_rangeHandlers[m_rangeHandlers.size() - 1]->m_callbacks.size() - 1]; // Last callback
+	rangeHandler->m_callbacks.push_back(std::make_shared<Callback>(p_callback, rangeHandler));
+	return rangeHandler->m_callbacks[rangeHandler->m_callbacks.size() - 1]; // Last callback
 }
 
 void KTech::Input::RegisterCallbackGroup(CallbackGroup* const p_callbackGroup)
@@ -23,9 +23,15 @@
 #define KTECH_DEFINITION
 #include "../../ktech.hpp"
 #undef KTECH_DEFINITION
+#include "../../utility/bytering.hpp"
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <limits>
 #include <string>
+#include <unordered_map>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -34,7 +40,6 @@
 #include <termio.h>
 #endif
 #include <memory>
-#include <mutex>
 #include <thread>
 
 /*!
@@ -47,6 +52,7 @@ public:
 
 	std::string input;
 	std::string quitKey{"\x03"};
+	long latency = 0;
 
 	[[nodiscard]] auto Is(const std::string& stringKey) const -> bool;
 	[[nodiscard]] auto Is(char charKey) const -> bool;
@@ -61,20 +67,39 @@ private:
 	struct Handler;
 	struct Callback;
 
+	// Precedes the characters of each input in `m_inputRing`
+	struct InputHeader
+	{
+		std::chrono::steady_clock::time_point received;
+		uint8_t length;
+	};
+
+	static constexpr size_t maxInputLength = std::numeric_limits<uint8_t>::max();
+	static constexpr size_t readBufferSize = 4096;
+	static constexpr int escapeTimeout = 25; // Milliseconds to wait for the rest of an incomplete escape sequence, before taking it as is (e.g., a lone escape key)
+
 	Engine& engine;
 #ifdef _WIN32
 	HANDLE m_stdinHandle;
 	DWORD m_oldMode;
 #else
 	termios m_oldTerminalAttributes;
+	int m_inputPipe[2] = {-1, -1}; // The input loop writes a byte to it after queuing inputs while `WaitForInput()` waits, to wake it
+	bool m_queuedUnsignaled = false; // Whether the input loop queued inputs since it last checked whether to signal `m_inputPipe`
+	std::atomic<bool> m_waitingForInput = false; // Whether `WaitForInput()` is waiting (or about to), so the input loop should signal `m_inputPipe`
+	int m_stopPipe[2] = {-1, -1}; // `~Input()` writes a byte to it to wake the input loop from waiting for stdin, so the thread can be joined
 #endif
 	bool m_changedThisTick = false;
 	std::thread m_inputLoop;
-	std::vector<std::string> m_inputQueue;
-	std::mutex m_inputQueueMutex;
+	std::atomic<bool> m_inputLoopEnded = false;
+	std::atomic<bool> m_stopping = false; // Set by `~Input()`, so the input loop stops waiting for room in `m_inputRing`
+	ByteRing<65536> m_inputRing; // Inputs queued by the input loop thread for `CallCallbacks()`
+	std::array<char, readBufferSize> m_readBuffer{}; // Used by the input loop thread; starts with the bytes that weren't queued yet
+	size_t m_unqueuedLength = 0; // ^
 	// Handlers cannot be deleted; their callbacks can be deleted
-	std::vector<std::shared_ptr<Handler>> m_stringHandlers;
+	std::unordered_map<std::string, std::shared_ptr<Handler>> m_stringHandlers; // By string
 	std::vector<std::shared_ptr<Handler>> m_rangeHandlers;
+	std::array<std::vector<std::shared_ptr<Handler>>, 256> m_rangeHandlersByChar; // Range handlers that include each character (indexed as `unsigned char`), in registration order
 	// Groups can be deleted
 	std::vector<CallbackGroup*> m_groups;
 
@@ -109,9 +134,16 @@ private:
 	void Update();
 	void CallStringHandlers();
 	void CallRangeHandlers();
-	void Get();
+	auto Get() -> bool;
+	auto QueueToken(const char* token, size_t length) -> bool;
+	void Queue(const char* input, size_t length);
+	void SignalQueued();
+	static auto GetTokenLength(const char* bytes, size_t size) -> size_t;
+	auto WaitForStdin(int timeout) -> bool;
 	void Loop();
+	void WaitForInput(long timeout);
 
 	friend class Engine;
 	friend class Output;
+	friend class Time;
 };
\ No newline at end of file
@@ -27,6 +27,11 @@
 #include "../world/object.hpp"
 #include "../world/ui.hpp"
 #include "../world/widget.hpp"
+#include "engine.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
 
 /*!
 	@brief Call the virtual `OnTick()` functions of all registered world structures.
@@ -46,50 +51,336 @@
 	}
 	@endcode
 
+	Only structures that override `OnTick()` are actually iterated: the default `OnTick()` implementations unsubscribe their structure from this function the first time they are called, so a large number of structures without `OnTick()` logic (like static `Object`s) costs nothing here. Because of that, don't call the base `OnTick()` implementation from your override; doing so stops your structure from ticking. The structures of each kind are called in the order they were created in.
+
+	`Object`s with `Object::m_parallelTick` set to `true` are called last (rather than in creation order), on as many threads as the hardware supports (kept by `Memory` between ticks). Their `OnTick()` functions should only change their own `Object`, and read the rest of the world (without changing it). Reading includes looking structures up: use the const `CachingRegistry` lookups (e.g., `std::as_const(engine.memory.objects)[id]`), since the non-const ones update the given `ID`'s cached slot, which other threads may be reading. `Object::UpdateBounds()` (needed after changing `Object::m_pos` or `Object::m_colliders` directly) is deferred automatically. Other changes, like moving the `Object` (which may push other `Object`s) or creating and destroying structures, should be passed to `Memory::Defer()`.
+
+	If `Memory::hibernation` is `true`, this function first updates which `Object`s hibernate. `Object`s whose extent (the rectangle enclosing their `Collider`s and `Texture`s, or just their position if they have neither) doesn't intersect any of the active regions hibernate: they are skipped in `OnTick()` calls, rendering and collision (see `Object::IsHibernating()`), until an active region reaches them again. The active regions of a `Map` are the views of its `Camera`s (extended by `Memory::cameraRegionMargin`) and `Memory::activeRegions`. `Object`s that aren't in a `Layer` within a `Map` don't hibernate. The `Object`s in the active regions are found through a spatial hash of their extents, kept by each `Layer` while hibernation is on, so `Object`s far from the player in large `Map`s cost nothing here either.
+
 	This function was placed in `Memory`, because this engine component has the most direct access to all of the world structures. Although, this function could have been technically placed easily anywhere else.
 */
 void KTech::Memory::CallOnTicks()
 {
-	for (UI* ui : uis.m_vec)
+	const Profiler::Scope profilerScope(engine.profiler, Profiler::Phase::onTicks);
+	UpdateHibernation();
+	// Iterated by index rather than with iterators, as `OnTick()` may add or remove structures
+	for (size_t i = 0; i < uis.m_ticking.size(); i++)
 	{
-		if (ui->OnTick() && !m_changedThisTick)
+		UI* ui = uis.GetTicking(i);
+		if (ui != nullptr && ui->OnTick())
 		{
 			m_changedThisTick = true;
+			engine.profiler.AddRenderCause(Profiler::RenderCauseSource::ui, ui->m_name);
 		}
 	}
-	for (Widget* widget : widgets.m_vec)
+	for (size_t i = 0; i < widgets.m_ticking.size(); i++)
 	{
-		if (widget->OnTick() && !m_changedThisTick)
+		Widget* widget = widgets.GetTicking(i);
+		if (widget != nullptr && widget->OnTick())
 		{
 			m_changedThisTick = true;
+			engine.profiler.AddRenderCause(Profiler::RenderCauseSource::widget, widget->m_name);
 		}
 	}
-	for (Map* map : maps.m_vec)
+	for (size_t i = 0; i < maps.m_ticking.size(); i++)
 	{
-		if (map->OnTick() && !m_changedThisTick)
+		Map* map = maps.GetTicking(i);
+		if (map != nullptr && map->OnTick())
 		{
 			m_changedThisTick = true;
+			engine.profiler.AddRenderCause(Profiler::RenderCauseSource::map, map->m_name);
 		}
 	}
-	for (Camera* camera : cameras.m_vec)
+	for (size_t i = 0; i < cameras.m_ticking.size(); i++)
 	{
-		if (camera->OnTick() && !m_changedThisTick)
+		Camera* camera = cameras.GetTicking(i);
+		if (camera != nullptr && camera->OnTick())
 		{
 			m_changedThisTick = true;
+			engine.profiler.AddRenderCause(Profiler::RenderCauseSource::camera, camera->m_name);
 		}
 	}
-	for (Layer* layer : layers.m_vec)
+	for (size_t i = 0; i < layers.m_ticking.size(); i++)
 	{
-		if (layer->OnTick() && !m_changedThisTick)
+		Layer* layer = layers.GetTicking(i);
+		if (layer != nullptr && layer->OnTick())
 		{
 			m_changedThisTick = true;
+			engine.profiler.AddRenderCause(Profiler::RenderCauseSource::layer, layer->m_name);
 		}
 	}
-	for (Object* object : objects.m_vec)
+	for (size_t i = 0; i < objects.m_ticking.size(); i++)
 	{
-		if (object->OnTick() && !m_changedThisTick)
+		Object* object = objects.GetTicking(i);
+		if (object != nullptr && object->m_active && !object->m_hibernating && !object->m_parallelTick)
 		{
-			m_changedThisTick = true;
+			if (object->OnTick())
+			{
+				m_changedThisTick = true;
+				engine.profiler.AddRenderCause(Profiler::RenderCauseSource::object, object->m_name);
+			}
+			object->UpdateBoundsIfStale();
+		}
+	}
+	CallParallelOnTicks();
+	// Forget structures that were removed or stopped ticking during this call
+	uis.ForgetNotTicking();
+	widgets.ForgetNotTicking();
+	maps.ForgetNotTicking();
+	cameras.ForgetNotTicking();
+	layers.ForgetNotTicking();
+	objects.ForgetNotTicking();
+}
+
+// Make `Object`s outside the active regions hibernate, and wake `Object`s inside them (or all of them, if `hibernation` was turned off).
+// Only the `Object`s found in the active regions (through the `Layer`s' hibernation hashes) and the ones that were awake are visited, so far hibernating `Object`s cost nothing.
+void KTech::Memory::UpdateHibernation()
+{
+	if (!hibernation)
+	{
+		if (m_trackingHibernation)
+		{
+			for (const auto& slot : objects.m_slots)
+			{
+				if (slot.structure != nullptr && slot.structure->m_hibernating)
+				{
+					slot.structure->m_hibernating = false;
+					slot.structure->UpdateBounds();
+				}
+			}
+			for (const auto& layerSlot : layers.m_slots)
+			{
+				if (layerSlot.structure != nullptr)
+				{
+					layerSlot.structure->m_hibernationHash.Clear();
+					layerSlot.structure->m_awakeObjects.clear();
+					layerSlot.structure->m_hibernatingObjects = 0;
+				}
+			}
+			m_trackingHibernation = false;
+		}
+		return;
+	}
+	if (!m_trackingHibernation)
+	{
+		// Start tracking; all `Object`s are awake at this point
+		m_trackingHibernation = true;
+		for (const auto& layerSlot : layers.m_slots)
+		{
+			if (Layer* layer = layerSlot.structure)
+			{
+				for (const ID<Object>& objectID : layer->m_objects)
+				{
+					if (Object* object = objects[objectID])
+					{
+						layer->UpdateSpatialHash(*object);
+					}
+				}
+				layer->m_awakeObjects = layer->m_objects;
+			}
+		}
+	}
+	m_hibernationUpdates++;
+	for (const auto& layerSlot : layers.m_slots)
+	{
+		Layer* layer = layerSlot.structure;
+		if (layer == nullptr)
+		{
+			continue;
+		}
+		Map* map = maps[layer->m_parentMap];
+		if (map == nullptr)
+		{
+			// `Object`s that aren't in a `Layer` within a `Map` don't hibernate
+			if (layer->m_hibernatingObjects != 0)
+			{
+				for (const ID<Object>& objectID : layer->m_objects)
+				{
+					Object* object = objects[objectID];
+					if (object != nullptr && object->m_hibernating)
+					{
+						object->m_hibernating = false;
+						object->UpdateBounds();
+					}
+				}
+				layer->m_hibernatingObjects = 0;
+			}
+			// Drop the `Object`s that left
+			if (layer->m_awakeObjects.size() != layer->m_objects.size())
+			{
+				layer->m_awakeObjects = layer->m_objects;
+			}
+			continue;
+		}
+		m_regions = activeRegions;
+		for (const ID<Camera>& cameraID : map->m_cameras)
+		{
+			if (const Camera* camera = cameras[cameraID])
+			{
+				m_regions.push_back({
+					camera->m_pos - Point(cameraRegionMargin, cameraRegionMargin),
+					camera->m_res + UPoint(cameraRegionMargin * 2, cameraRegionMargin * 2)
+				});
+			}
+		}
+		// Wake the `Object`s whose extents intersect an active region
+		m_awakeObjects.clear();
+		for (const Region& region : m_regions)
+		{
+			const Point regionEnd = region.position + region.size;
+			m_regionObjects.clear();
+			layer->m_hibernationHash.Query(region.position, regionEnd, m_regionObjects);
+			for (const ID<Object>& objectID : m_regionObjects)
+			{
+				Object* object = objects[objectID];
+				if (object == nullptr || object->m_parentLayer != layer->m_id || object->m_hibernationUpdate == m_hibernationUpdates)
+				{
+					continue;
+				}
+				Point start;
+				Point end;
+				object->GetExtent(start, end);
+				// The hash only tells which cells are shared
+				if (start.x >= regionEnd.x || end.x <= region.position.x || start.y >= regionEnd.y || end.y <= region.position.y)
+				{
+					continue;
+				}
+				object->m_hibernationUpdate = m_hibernationUpdates;
+				m_awakeObjects.push_back(objectID);
+				if (object->m_hibernating)
+				{
+					object->m_hibernating = false;
+					layer->m_hibernatingObjects--;
+					object->UpdateBounds();
+				}
+			}
+		}
+		// Put the rest of the awake `Object`s to sleep
+		for (const ID<Object>& objectID : layer->m_awakeObjects)
+		{
+			Object* object = objects[objectID];
+			if (object != nullptr && object->m_parentLayer == layer->m_id && !object->m_hibernating && object->m_hibernationUpdate != m_hibernationUpdates)
+			{
+				object->m_hibernating = true;
+				layer->m_hibernatingObjects++;
+				object->UpdateBounds();
+			}
+		}
+		std::swap(layer->m_awakeObjects, m_awakeObjects);
+	}
+}
+
+// Whether there are structures whose `OnTick()` `CallOnTicks()` would call. Like there, inactive and hibernating `Object`s (e.g., those waiting in an `ObjectPool`) don't count.
+auto KTech::Memory::HasTickingStructures() const -> bool
+{
+	if (!uis.m_ticking.empty()
+		|| !widgets.m_ticking.empty()
+		|| !maps.m_ticking.empty()
+		|| !cameras.m_ticking.empty()
+		|| !layers.m_ticking.empty())
+	{
+		return true;
+	}
+	for (size_t i = 0; i < objects.m_ticking.size(); i++)
+	{
+		const Object* object = objects.GetTicking(i);
+		if (object != nullptr && object->m_active && !object->m_hibernating)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/*!
+	@brief Run a command after all parallel `OnTick()`s are done.
+
+	Meant for `Object`s with `Object::m_parallelTick` set to `true`: their `OnTick()` functions run in parallel, so they can't safely change the world beyond their own `Object`. Instead, they can pass such changes (like `Object::Move()`, or creating and destroying structures) to this function. The commands are run by `Memory::CallOnTicks()` after all the parallel `OnTick()`s are done, in the order of the `Object`s that deferred them (regardless of the threads' timing).
+
+	Outside of a parallel `OnTick()`, the command is simply run immediately.
+
+	@param command The function to run.
+
+	@see `Object::m_parallelTick`
+*/
+void KTech::Memory::Defer(std::function<void()> p_command)
+{
+	if (m_deferredCommands == nullptr)
+	{
+		p_command();
+		return;
+	}
+	m_deferredCommands->push_back(std::move(p_command));
+}
+
+// Call the `OnTick()` of the `Object`s marked `m_parallelTick`, spread in contiguous shares between the worker pool's threads, and then run their deferred commands.
+void KTech::Memory::CallParallelOnTicks()
+{
+	m_parallelObjects.clear();
+	for (size_t i = 0; i < objects.m_ticking.size(); i++)
+	{
+		Object* object = objects.GetTicking(i);
+		if (object != nullptr && object->m_active && !object->m_hibernating && object->m_parallelTick)
+		{
+			m_parallelObjects.push_back(object);
+		}
+	}
+	if (m_parallelObjects.empty())
+	{
+		return;
+	}
+
+	const size_t threadsCount = std::min(m_parallelObjects.size(), m_workerPool.GetThreadsCount());
+	std::vector<std::vector<std::function<void()>>> commands(threadsCount); // Per share
+	std::atomic<bool> changed = false;
+	std::vector<uint8_t> objectsChanged(engine.profiler.trackRenderCauses ? m_parallelObjects.size() : 0); // For render cause tracking
+	auto work = [&](size_t p_share)
+	{
+		m_deferredCommands = &commands[p_share];
+		bool shareChanged = false;
+		const size_t end = m_parallelObjects.size() * (p_share + 1) / threadsCount;
+		for (size_t i = m_parallelObjects.size() * p_share / threadsCount; i < end; i++)
+		{
+			if (m_parallelObjects[i]->OnTick())
+			{
+				shareChanged = true;
+				if (!objectsChanged.empty())
+				{
+					objectsChanged[i] = 1;
+				}
+			}
+		}
+		if (shareChanged)
+		{
+			changed = true;
+		}
+		m_deferredCommands = nullptr;
+	};
+	m_workerPool.Run(threadsCount, work);
+	if (changed)
+	{
+		m_changedThisTick = true;
+	}
+	for (size_t i = 0; i < objectsChanged.size(); i++)
+	{
+		if (objectsChanged[i] != 0)
+		{
+			engine.profiler.AddRenderCause(Profiler::RenderCauseSource::object, m_parallelObjects[i]->m_name);
+		}
+	}
+
+	// Before the deferred commands, which may remove `Object`s
+	for (Object* object : m_parallelObjects)
+	{
+		object->UpdateBoundsIfStale();
+	}
+
+	// Shares are contiguous, so this is the order of the `Object`s
+	for (std::vector<std::function<void()>>& shareCommands : commands)
+	{
+		for (std::function<void()>& command : shareCommands)
+		{
+			command();
 		}
 	}
 }
\ No newline at end of file
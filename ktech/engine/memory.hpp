@@ -24,6 +24,12 @@
 #include "../ktech.hpp"
 #undef KTECH_DEFINITION
 #include "../utility/cachingregistry.hpp"
+#include "../utility/workerpool.hpp"
+#include "../basic/point.hpp"
+#include "../basic/upoint.hpp"
+
+#include <functional>
+#include <vector>
 
 /*!
 	@brief Engine component responsible for registering all world structures.
@@ -35,6 +41,13 @@
 class KTech::Memory
 {
 public:
+	//! @brief Rectangle in which `Object`s don't hibernate.
+	struct Region
+	{
+		Point position; //!< Top-left corner.
+		UPoint size; //!< Size.
+	};
+
 	CachingRegistry<Object> objects; //!< `Object`s registry.
 	CachingRegistry<Layer> layers; //!< `Layer`s registry.
 	CachingRegistry<Camera> cameras; //!< `Camera`s registry.
@@ -42,10 +55,36 @@ public:
 	CachingRegistry<Widget> widgets; //!< `Widget`s registry.
 	CachingRegistry<UI> uis; //!< `UI`s registry.
 
+	bool hibernation = false; //!< `true`: `Object`s outside the active regions hibernate (see `Memory::CallOnTicks()`). `false` (default): all `Object`s are awake.
+	std::vector<Region> activeRegions; //!< Active regions in every `Map`, in addition to the views of `Camera`s.
+	int32_t cameraRegionMargin = 16; //!< How far beyond its view (on each side) a `Camera`'s active region extends.
+
 	void CallOnTicks();
+	void Defer(std::function<void()> command);
 
 private:
+	Engine& engine;
 	bool m_changedThisTick = false;
+	bool m_trackingHibernation = false; // Whether `hibernation` was `true` at the last `UpdateHibernation()`, so `Layer`s keep their hibernation hashes and awake `Object`s
+	size_t m_hibernationUpdates = 0; // Number of `UpdateHibernation()` calls while tracking, which stamp the `Object`s they find in active regions
+	std::vector<Region> m_regions; // Work buffer of `UpdateHibernation()`
+	std::vector<ID<Object>> m_regionObjects; // ^
+	std::vector<ID<Object>> m_awakeObjects; // ^
+	std::vector<Object*> m_parallelObjects; // Work buffer of `CallOnTicks()`
+	WorkerPool m_workerPool; // Runs `CallParallelOnTicks()` and `Collision::MoveObjectsParallel()`
+	inline static thread_local std::vector<std::function<void()>>* m_deferredCommands = nullptr; // Command buffer of the calling thread's share of `CallParallelOnTicks()`; `nullptr` outside of it
+
+	inline Memory(Engine& engine)
+		: engine(engine) {}
+
+	void UpdateHibernation();
+	void CallParallelOnTicks();
+	[[nodiscard]] auto HasTickingStructures() const -> bool;
 
+	friend class Collision;
+	friend class Engine;
+	friend class Layer;
+	friend class Object;
 	friend class Output;
+	friend class Time;
 };
\ No newline at end of file
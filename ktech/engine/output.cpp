@@ -152,6 +152,7 @@ void KTech::Output::Clear()
 */
 void KTech::Output::Draw(const std::vector<Cell>& p_sourceImage, UPoint p_resolution, Point p_position, UPoint p_start, UPoint p_end, uint8_t p_alpha)
 {
+	const Profiler::Scope profilerScope(engine.profiler, Profiler::Phase::draw);
 	// Default the rectangle
 	if (p_end.x == 0)
 	{
@@ -213,6 +214,7 @@ void KTech::Output::Draw(const std::vector<Cell>& p_sourceImage, UPoint p_resolu
 */
 void KTech::Output::Draw(const std::vector<CellA>& p_sourceImage, UPoint p_resolution, Point p_position, UPoint p_start, UPoint p_end, uint8_t p_alpha)
 {
+	const Profiler::Scope profilerScope(engine.profiler, Profiler::Phase::draw);
 	// Default the rectangle
 	if (p_end.x == 0)
 	{
@@ -263,6 +265,8 @@ void KTech::Output::Draw(const std::vector<CellA>& p_sourceImage, UPoint p_resol
 */
 void KTech::Output::Print()
 {
+	const Profiler::Scope profilerScope(engine.profiler, Profiler::Phase::print);
+	KTECH_TRACE_SPAN("Output::Print");
 	/*
 		This is a very old function.
 
@@ -321,6 +325,8 @@ void KTech::Output::Print()
 		}
 		PopulateEndOfLine(l);
 	}
+	// Nested in the "Output::Print" span, leaving the rest of it to encoding
+	KTECH_TRACE_SPAN("Output::Print write");
 	if (engine.noGameLoopMode)
 	{
 		// PRINT while moving the cursor to the next line (no-game-loop mode).
@@ -349,6 +355,8 @@ void KTech::Output::Print()
 
 	When no-game-loop mode is enabled, this function always returns true.
 
+	The decisions are counted in `Profiler::renders` and `Profiler::skippedRenders`. To find out which functions requested the renders, see `Profiler::trackRenderCauses`.
+
 	@return Whether you should render and draw again.
 
 	@see `Output::ShouldPrintThisTick()`
@@ -361,6 +369,10 @@ auto KTech::Output::ShouldRenderThisTick() -> bool
 		// ALWAYS RETURN true if no-game-loop mode is enabled.
 		return true;
 	}
+	if (engine.time.ticksCounter == 0)
+	{
+		engine.profiler.AddRenderCause(Profiler::RenderCauseSource::firstTick);
+	}
 	if (engine.input.m_changedThisTick
 		|| engine.memory.m_changedThisTick
 		|| engine.time.m_changedThisTick
@@ -369,8 +381,10 @@ auto KTech::Output::ShouldRenderThisTick() -> bool
 		engine.input.m_changedThisTick = false;
 		engine.memory.m_changedThisTick = false;
 		engine.time.m_changedThisTick = false;
+		engine.profiler.EndRenderDecision(true);
 		return true;
 	}
+	engine.profiler.EndRenderDecision(false);
 	return false;
 }
 
@@ -0,0 +1,366 @@
+/*
+	KTech, Kaup's C++ 2D terminal game engine library.
+	Copyright (C) 2023-2025 Ethan Kaufman (AKA Kaup)
+
+	This file is part of KTech.
+
+	KTech is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	any later version.
+
+	KTech is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with KTech. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+/*!
+	@var `Profiler::enabled`
+
+	@brief Whether phases are measured.
+
+	While `false`, the only cost of the profiler is checking this variable once per phase. While `true`, the engine components time their phases, sum the durations of each phase (e.g., all the `Camera::Render()` calls) over a game loop iteration, and record the sums when `Time::WaitUntilNextTick()` returns. A phase that didn't occur in an iteration (e.g., rendering was skipped) isn't recorded in that iteration.
+
+	@see `Profiler::GetStatistics()`
+	@see `Profiler::GetReport()`
+*/
+
+/*!
+	@var `Profiler::trackRenderCauses`
+
+	@brief Whether to remember which functions requested renders.
+
+	`Output::ShouldRenderThisTick()` returns `true` if any callback or `OnTick()` function returned `true` since it was last called (see its documentation). When this variable is `true`, the engine components also tell the profiler which function it was, so you can find out why the game renders, and catch functions that return `true` needlessly (which cost a full render each tick).
+
+	`Profiler::renders` and `Profiler::skippedRenders` are counted regardless.
+
+	@see `Profiler::GetLastRenderCauses()`
+	@see `Profiler::GetRenderCauses()`
+*/
+
+/*!
+	@brief Get statistics of a phase's durations over the recent game loop iterations.
+
+	Safe to call from any thread (e.g., a debug overlay's), as the histories are lock-free ring buffers.
+
+	@param phase The phase to get statistics of.
+
+	@return `Statistics` of the phase, in microseconds. All zeros if the phase wasn't recorded yet.
+*/
+auto KTech::Profiler::GetStatistics(Phase p_phase) const -> Statistics
+{
+	const History& history = m_histories[static_cast<size_t>(p_phase)];
+	const size_t written = history.written.load(std::memory_order_acquire);
+	Statistics statistics;
+	statistics.samples = std::min(written, historyLength);
+	if (statistics.samples == 0)
+	{
+		return statistics;
+	}
+	std::vector<long> samples(statistics.samples);
+	long sum = 0;
+	for (size_t i = 0; i < statistics.samples; i++)
+	{
+		samples[i] = history.samples[(written - 1 - i) % historyLength].load(std::memory_order_relaxed);
+		sum += samples[i];
+	}
+	statistics.last = samples[0];
+	statistics.average = sum / static_cast<long>(statistics.samples);
+	std::sort(samples.begin(), samples.end());
+	// Nearest-rank percentile
+	auto percentile = [&samples](size_t percent) {
+		return samples[(samples.size() * percent + 99) / 100 - 1];
+	};
+	statistics.p50 = percentile(50);
+	statistics.p95 = percentile(95);
+	statistics.p99 = percentile(99);
+	statistics.max = samples.back();
+	return statistics;
+}
+
+/*!
+	@brief Get a human-readable table of all phases' statistics.
+
+	Meant to be logged, or printed on quit (see `Output::outputOnQuit`).
+
+	@return A line per phase, with its `Statistics` in microseconds.
+*/
+auto KTech::Profiler::GetReport() const -> std::string
+{
+	std::string report = "phase         samples     last      avg      p50      p95      p99      max\n";
+	for (size_t i = 0; i < phaseCount; i++)
+	{
+		const Statistics statistics = GetStatistics(static_cast<Phase>(i));
+		std::string line = GetName(static_cast<Phase>(i));
+		line.resize(13, ' ');
+		for (const long value : {static_cast<long>(statistics.samples), statistics.last, statistics.average, statistics.p50, statistics.p95, statistics.p99, statistics.max})
+		{
+			std::string number = std::to_string(value);
+			line += std::string(number.size() < 9 ? 9 - number.size() : 1, ' ') + number;
+		}
+		report += line + '\n';
+	}
+	report += "renders " + std::to_string(renders) + ", skipped " + std::to_string(skippedRenders) + '\n';
+	for (const RenderCause& cause : GetRenderCauses())
+	{
+		report += "render cause " + std::to_string(cause.count) + "x " + GetName(cause.source) + (cause.name.empty() ? "" : " \"" + cause.name + '"') + '\n';
+	}
+	return report;
+}
+
+/*!
+	@brief Get the functions that requested the last render.
+
+	Requires `Profiler::trackRenderCauses` to be `true`. Should be called from the game loop thread.
+
+	@return The functions that requested a render since the second-to-last render, in the order they did, each with a `RenderCause::count` of 1.
+
+	@see `Profiler::GetRenderCauses()`
+*/
+auto KTech::Profiler::GetLastRenderCauses() const -> const std::vector<RenderCause>&
+{
+	return m_lastRenderCauses;
+}
+
+/*!
+	@brief Get the functions that requested the most renders.
+
+	Requires `Profiler::trackRenderCauses` to be `true`. Counts render requests since `Profiler::Reset()`, grouping together `OnTick()` functions of world structures with the same `m_name` (so, name your structures to tell them apart). Should be called from the game loop thread.
+
+	A function that requests a render in nearly every tick (compare its count with `Time::ticksCounter`) may be returning `true` by mistake.
+
+	@param count How many functions to get, at most.
+
+	@return The functions, from the one that requested the most renders.
+
+	@see `Profiler::GetLastRenderCauses()`
+*/
+auto KTech::Profiler::GetRenderCauses(size_t p_count) const -> std::vector<RenderCause>
+{
+	std::vector<RenderCause> causes;
+	causes.reserve(m_renderCauseCounts.size());
+	for (const auto& [key, count] : m_renderCauseCounts)
+	{
+		causes.push_back({key.first, key.second, count});
+	}
+	std::stable_sort(causes.begin(), causes.end(), [](const RenderCause& cause1, const RenderCause& cause2) {
+		return cause1.count > cause2.count;
+	});
+	if (causes.size() > p_count)
+	{
+		causes.resize(p_count);
+	}
+	return causes;
+}
+
+/*!
+	@brief Clear the recorded histories of all phases, the render counters and the render causes.
+
+	Should be called from the game loop thread.
+*/
+void KTech::Profiler::Reset()
+{
+	for (History& history : m_histories)
+	{
+		history.written.store(0, std::memory_order_release);
+		history.current = 0;
+		history.occurred = false;
+	}
+	renders = 0;
+	skippedRenders = 0;
+	m_renderCauses.clear();
+	m_lastRenderCauses.clear();
+	m_renderCauseCounts.clear();
+}
+
+/*!
+	@brief Write the recorded trace spans to a file in the Chrome trace event format.
+
+	Only available if the library was built with `KTECH_TRACE` defined (`premake5 --ktech-trace`); otherwise nothing is recorded in the first place. In that build, the engine records spans of its hot paths: rendering of each `Layer` in `Camera::Render()`, each move resolved by `Collision` (including those of `Collision::MoveObjectsParallel()`'s worker threads), encoding versus writing in `Output::Print()`, and each invocation called by `Time::CallInvocations()`. Each thread records into a buffer of its own.
+
+	The written spans are discarded from memory, so calling this function again writes only the spans recorded since. The file can be opened in Perfetto (https://ui.perfetto.dev) or "chrome://tracing".
+
+	To write the trace when the game quits instead, set `Profiler::traceFileOnQuit`.
+
+	Shouldn't be called while the engine's worker threads are running (e.g., from within `OnTick()`).
+
+	@param path Path of the file to write (overwritten if it exists).
+
+	@return `true`: written. `false`: the library wasn't built with `KTECH_TRACE`, or the file couldn't be opened.
+*/
+auto KTech::Profiler::WriteTrace(const std::string& p_path) -> bool
+{
+#ifndef KTECH_TRACE
+	static_cast<void>(p_path);
+	return false;
+#else
+	std::ofstream file(p_path);
+	if (!file)
+	{
+		return false;
+	}
+	// Collect the events
+	std::vector<TraceEvent> events;
+	{
+		const std::lock_guard<std::mutex> lockGuard(m_traceMutex);
+		events.swap(m_finishedTraceEvents);
+		for (TraceBuffer* buffer : m_traceBuffers)
+		{
+			const std::lock_guard<std::mutex> bufferLockGuard(buffer->mutex);
+			events.insert(events.end(), buffer->events.begin(), buffer->events.end());
+			buffer->events.clear();
+		}
+	}
+	// Write "complete" events, timed in microseconds
+	file << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	for (size_t i = 0; i < events.size(); i++)
+	{
+		file << (i == 0 ? "\n" : ",\n")
+			<< "{\"name\":\"" << events[i].name
+			<< "\",\"cat\":\"ktech\",\"ph\":\"X\",\"pid\":1,\"tid\":" << events[i].thread
+			<< ",\"ts\":" << std::chrono::duration<double, std::micro>(events[i].start.time_since_epoch()).count()
+			<< ",\"dur\":" << std::chrono::duration<double, std::micro>(events[i].duration).count() << '}';
+	}
+	file << "\n]}\n";
+	return static_cast<bool>(file);
+#endif
+}
+
+/*!
+	@brief Get the name of a phase.
+
+	@param phase The phase.
+
+	@return The name of the `Phase` enumerator (e.g., "cameraRender").
+*/
+auto KTech::Profiler::GetName(Phase p_phase) -> const char*
+{
+	switch (p_phase)
+	{
+		case Phase::input: return "input";
+		case Phase::invocations: return "invocations";
+		case Phase::onTicks: return "onTicks";
+		case Phase::cameraRender: return "cameraRender";
+		case Phase::uiRender: return "uiRender";
+		case Phase::draw: return "draw";
+		case Phase::print: return "print";
+		case Phase::sleep: default: return "sleep";
+	}
+}
+
+/*!
+	@brief Get the name of a render cause source.
+
+	@param source The source.
+
+	@return The name of the `RenderCauseSource` enumerator (e.g., "object").
+*/
+auto KTech::Profiler::GetName(RenderCauseSource p_source) -> const char*
+{
+	switch (p_source)
+	{
+		case RenderCauseSource::firstTick: return "firstTick";
+		case RenderCauseSource::input: return "input";
+		case RenderCauseSource::invocation: return "invocation";
+		case RenderCauseSource::ui: return "ui";
+		case RenderCauseSource::widget: return "widget";
+		case RenderCauseSource::map: return "map";
+		case RenderCauseSource::camera: return "camera";
+		case RenderCauseSource::layer: return "layer";
+		case RenderCauseSource::object: default: return "object";
+	}
+}
+
+// Add a duration (microseconds) to a phase in the current game loop iteration.
+void KTech::Profiler::Add(Phase p_phase, long p_duration)
+{
+	History& history = m_histories[static_cast<size_t>(p_phase)];
+	history.current += p_duration;
+	history.occurred = true;
+}
+
+// Record the durations of the phases that occurred in the ending game loop iteration.
+void KTech::Profiler::EndIteration()
+{
+	for (History& history : m_histories)
+	{
+		if (!history.occurred)
+		{
+			continue;
+		}
+		const size_t written = history.written.load(std::memory_order_relaxed);
+		history.samples[written % historyLength].store(history.current, std::memory_order_relaxed);
+		history.written.store(written + 1, std::memory_order_release);
+		history.current = 0;
+		history.occurred = false;
+	}
+}
+
+// Remember a function that requested a render, if `trackRenderCauses` is on.
+void KTech::Profiler::AddRenderCause(RenderCauseSource p_source, const std::string& p_name)
+{
+	if (!trackRenderCauses)
+	{
+		return;
+	}
+	m_renderCauses.push_back({p_source, p_name});
+	m_renderCauseCounts[{p_source, p_name}]++;
+}
+
+// Count the decision of `Output::ShouldRenderThisTick()`, and if it's to render, keep the causes that led to it.
+void KTech::Profiler::EndRenderDecision(bool p_render)
+{
+	if (!p_render)
+	{
+		skippedRenders++;
+		return;
+	}
+	renders++;
+	m_lastRenderCauses.swap(m_renderCauses);
+	m_renderCauses.clear();
+}
+
+KTech::Profiler::~Profiler()
+{
+	if (!traceFileOnQuit.empty())
+	{
+		WriteTrace(traceFileOnQuit);
+	}
+}
+
+KTech::Profiler::Span::Span(const char* p_name)
+	: m_name(p_name), m_start(std::chrono::steady_clock::now()) {}
+
+KTech::Profiler::Span::~Span()
+{
+	const auto end = std::chrono::steady_clock::now();
+	const std::lock_guard<std::mutex> lockGuard(m_traceBuffer.mutex);
+	m_traceBuffer.events.push_back({m_name, m_traceBuffer.thread, m_start, end - m_start});
+}
+
+KTech::Profiler::TraceBuffer::TraceBuffer()
+{
+	const std::lock_guard<std::mutex> lockGuard(m_traceMutex);
+	thread = m_traceThreads;
+	m_traceThreads++;
+	m_traceBuffers.push_back(this);
+}
+
+// Keep the events of the ending thread until they are written
+KTech::Profiler::TraceBuffer::~TraceBuffer()
+{
+	const std::lock_guard<std::mutex> lockGuard(m_traceMutex);
+	m_finishedTraceEvents.insert(m_finishedTraceEvents.end(), events.begin(), events.end());
+	m_traceBuffers.erase(std::find(m_traceBuffers.begin(), m_traceBuffers.end(), this));
+}
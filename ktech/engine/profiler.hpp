@@ -0,0 +1,215 @@
+/*
+	KTech, Kaup's C++ 2D terminal game engine library.
+	Copyright (C) 2023-2025 Ethan Kaufman (AKA Kaup)
+
+	This file is part of KTech.
+
+	KTech is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	any later version.
+
+	KTech is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with KTech. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#define KTECH_DEFINITION
+#include "../ktech.hpp"
+#undef KTECH_DEFINITION
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef KTECH_TRACE
+// Record a trace span until the end of the scope (the span's variable is named after the line, so a scope can have several)
+#define KTECH_TRACE_SPAN(name) KTECH_TRACE_SPAN_AT(name, __LINE__)
+#define KTECH_TRACE_SPAN_AT(name, line) KTECH_TRACE_SPAN_LINE(name, line) // Expands `__LINE__` before it's concatenated
+#define KTECH_TRACE_SPAN_LINE(name, line) const KTech::Profiler::Span ktechTraceSpan##line(name)
+#else
+#define KTECH_TRACE_SPAN(name)
+#endif
+
+/*!
+	@brief Engine component responsible for measuring how long each phase of the game loop takes.
+
+	Disabled by default; see `Profiler::enabled`.
+
+	If the library is built with `KTECH_TRACE` defined (`premake5 --ktech-trace`), the engine's hot paths also record trace spans, which can be viewed on a timeline; see `Profiler::WriteTrace()`.
+*/
+class KTech::Profiler
+{
+public:
+	//! @brief Engine function (or group of functions) that is measured.
+	enum class Phase : uint8_t
+	{
+		input, //!< `Input::CallCallbacks()`.
+		invocations, //!< `Time::CallInvocations()`.
+		onTicks, //!< `Memory::CallOnTicks()`.
+		cameraRender, //!< `Camera::Render()`.
+		uiRender, //!< `UI::Render()`.
+		draw, //!< `Output::Draw()`.
+		print, //!< `Output::Print()`.
+		sleep //!< Sleeping in `Time::WaitUntilNextTick()`.
+	};
+
+	//! @brief Durations of a `Phase` over recent game loop iterations, in microseconds.
+	struct Statistics
+	{
+		size_t samples = 0; //!< Number of recent game loop iterations in which the phase occurred (up to `Profiler::historyLength`).
+		long last = 0; //!< Latest.
+		long average = 0; //!< Mean.
+		long p50 = 0; //!< Median.
+		long p95 = 0; //!< 95th percentile.
+		long p99 = 0; //!< 99th percentile.
+		long max = 0; //!< Longest.
+	};
+
+	//! @brief Kind of function that requested a render (see `Profiler::trackRenderCauses`).
+	enum class RenderCauseSource : uint8_t
+	{
+		firstTick, //!< The first tick always renders.
+		input, //!< Input callback function (see `CallbackGroup::RegisterCallback()`).
+		invocation, //!< Invoked callback function (see `Time::Invocation`).
+		ui, //!< `UI::OnTick()`.
+		widget, //!< `Widget::OnTick()`.
+		map, //!< `Map::OnTick()`.
+		camera, //!< `Camera::OnTick()`.
+		layer, //!< `Layer::OnTick()`.
+		object //!< `Object::OnTick()`.
+	};
+
+	//! @brief Function (or group of functions) that requested renders.
+	struct RenderCause
+	{
+		RenderCauseSource source; //!< Kind of function.
+		std::string name; //!< `m_name` of the world structure whose `OnTick()` it is, or the input that triggered the input callback function (empty for the other sources).
+		unsigned long count = 1; //!< How many times it requested a render.
+	};
+
+	static constexpr size_t phaseCount = 8; //!< Number of `Phase`s.
+	static constexpr size_t historyLength = 256; //!< How many recent game loop iterations are kept per `Phase`.
+
+	bool enabled = false; //!< `true`: measure phases. `false` (default): don't, and keep the recorded history as is.
+	std::string traceFileOnQuit; //!< Path of a file to write the trace to when the game quits (see `Profiler::WriteTrace()`). Empty (default): don't.
+	bool trackRenderCauses = false; //!< `true`: remember which functions requested renders (see `Profiler::GetRenderCauses()`). `false` (default): don't.
+	unsigned long renders = 0; //!< Times `Output::ShouldRenderThisTick()` returned `true`.
+	unsigned long skippedRenders = 0; //!< Times `Output::ShouldRenderThisTick()` returned `false`.
+
+	[[nodiscard]] auto GetStatistics(Phase phase) const -> Statistics;
+	[[nodiscard]] auto GetReport() const -> std::string;
+	[[nodiscard]] auto GetLastRenderCauses() const -> const std::vector<RenderCause>&;
+	[[nodiscard]] auto GetRenderCauses(size_t count = 10) const -> std::vector<RenderCause>;
+	void Reset();
+
+	static auto WriteTrace(const std::string& path) -> bool;
+
+	[[nodiscard]] static auto GetName(Phase phase) -> const char*;
+	[[nodiscard]] static auto GetName(RenderCauseSource source) -> const char*;
+
+private:
+	// Measures the duration of its own scope, and adds it to a phase's current game loop iteration
+	class Scope
+	{
+	public:
+		inline Scope(Profiler& profiler, Phase phase)
+			: m_profiler(profiler.enabled ? &profiler : nullptr), m_phase(phase)
+		{
+			if (m_profiler != nullptr)
+			{
+				m_start = std::chrono::steady_clock::now();
+			}
+		}
+
+		inline ~Scope()
+		{
+			if (m_profiler != nullptr)
+			{
+				m_profiler->Add(m_phase, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count());
+			}
+		}
+
+	private:
+		Profiler* m_profiler; // `nullptr` if the profiler was disabled when the scope started
+		Phase m_phase;
+		std::chrono::steady_clock::time_point m_start;
+	};
+
+	// Records a trace span from its construction until its destruction (see `KTECH_TRACE_SPAN`)
+	class Span
+	{
+	public:
+		Span(const char* name);
+		~Span();
+
+	private:
+		const char* m_name;
+		std::chrono::steady_clock::time_point m_start;
+	};
+
+	struct TraceEvent
+	{
+		const char* name;
+		size_t thread;
+		std::chrono::steady_clock::time_point start;
+		std::chrono::steady_clock::duration duration;
+	};
+
+	// A thread's recorded spans; registered in `m_traceBuffers` while the thread lives
+	struct TraceBuffer
+	{
+		size_t thread;
+		std::mutex mutex; // Locked by the owning thread only when adding an event, so `WriteTrace()` can collect from any thread
+		std::vector<TraceEvent> events;
+
+		TraceBuffer();
+		~TraceBuffer();
+	};
+
+	// Ring buffer of a phase's durations; written only by the game loop thread, and readable from any thread
+	struct History
+	{
+		std::array<std::atomic<long>, historyLength> samples{};
+		std::atomic<size_t> written = 0; // Total samples written; the latest is at `(written - 1) % historyLength`
+		long current = 0; // Accumulated duration in the current game loop iteration
+		bool occurred = false; // Whether the phase occurred in the current game loop iteration
+	};
+
+	std::array<History, phaseCount> m_histories;
+	std::vector<RenderCause> m_renderCauses; // Render requests since `Output::ShouldRenderThisTick()` was last called
+	std::vector<RenderCause> m_lastRenderCauses; // Render requests that led to the last render
+	std::map<std::pair<RenderCauseSource, std::string>, unsigned long> m_renderCauseCounts; // Render requests since `Reset()`, by function
+	inline static std::mutex m_traceMutex; // Protects `m_traceBuffers`, `m_finishedTraceEvents` and `m_traceThreads`
+	inline static std::vector<TraceBuffer*> m_traceBuffers; // Buffers of the living threads
+	inline static std::vector<TraceEvent> m_finishedTraceEvents; // Events of the threads that ended
+	inline static size_t m_traceThreads = 0; // Threads that recorded spans so far
+	inline static thread_local TraceBuffer m_traceBuffer;
+
+	Profiler() = default;
+	~Profiler();
+
+	void Add(Phase phase, long duration);
+	void EndIteration();
+	void AddRenderCause(RenderCauseSource source, const std::string& name = "");
+	void EndRenderDecision(bool render);
+
+	friend class Camera;
+	friend class Collision;
+	friend class Engine;
+	friend class Input;
+	friend class Memory;
+	friend class Output;
+	friend class Time;
+	friend class UI;
+};
@@ -29,17 +29,14 @@
 	@see `Output::ShouldRenderThisTick()`
 */
 KTech::Time::Invocation::Invocation(Engine& engine, const std::function<bool()>& callback)
-	: engine(engine), m_callback(callback)
-{
-	engine.time.RegisterCallback(this);
-}
+	: engine(engine), m_callback(callback) {}
 
 /*!
 	@brief Safely deregister invocation from `Time`.
 */
 KTech::Time::Invocation::~Invocation()
 {
-	engine.time.DeregisterCallback(nullptr);
+	engine.time.Unschedule(this);
 }
 
 /*!
@@ -74,6 +71,8 @@ KTech::Time::Invocation::~Invocation()
 	// 3
 	@endcode
 
+	Time starts passing from the next call to `Time::CallInvocations()`, so your function isn't called by the current call to `Time::CallInvocations()` even if `time` is 0 (and if this is called from within an invoked function).
+
 	@param time Duration to wait for before calling your function.
 	@param measurement The time measurement for your given `time`.
 
@@ -84,6 +83,9 @@ void KTech::Time::Invocation::Invoke(long time, Measurement measurement)
 	m_duration = engine.time.TimeToMicroseconds(time, measurement);
 	m_timePassed = 0;
 	m_active = true;
+	m_start = engine.time.m_invocationsClock;
+	m_order = engine.time.m_invocationsCounter++;
+	engine.time.Schedule(this);
 }
 
 /*!
@@ -91,6 +93,21 @@ void KTech::Time::Invocation::Invoke(long time, Measurement measurement)
 */
 void KTech::Time::Invocation::Cancel()
 {
+	if (m_active)
+	{
+		m_timePassed = GetTimePassed();
+	}
 	m_active = false;
 	m_duration = 0;
+	engine.time.Unschedule(this);
+}
+
+/*!
+	@brief Get how much time passed since the invocation started.
+
+	@return Time passed in microseconds, since invocation started until now (if active), or until invocation ended (if inactive).
+*/
+auto KTech::Time::Invocation::GetTimePassed() const -> long
+{
+	return m_active ? engine.time.m_invocationsClock - m_start : m_timePassed;
 }
\ No newline at end of file
@@ -18,9 +18,14 @@
 	along with KTech. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#pragma once
+
 #include "time.hpp"
 #include "../engine.hpp"
 
+#include <functional>
+#include <limits>
+
 /*!
 	@brief Calls a function after a given time.
 
@@ -69,12 +74,28 @@ struct KTech::Time::Invocation
 	Engine& engine; //!< Parent `Engine`.
 	std::function<bool()> m_callback; //!< Function to invoke.
 	bool m_active = false; //!< Whether currently invoked (`true`: invoked, `false`: stationary).
-	long m_timePassed = 0; //!< How much time (in microseconds) actually passed since invocation started until now (if active), or until invocation ended (if inactive).
+	long m_timePassed = 0; //!< How much time (in microseconds) actually passed since invocation started until it ended (updated when the invocation ends; see `Invocation::GetTimePassed()` for the time passed so far).
 	long m_duration = 0; //!< How much time (in microseconds) should pass before your function gets called (if active), or 0 (if inactive).
 
 	Invocation(Engine& engine, const std::function<bool()>& callback);
+	// Not copyable nor movable: `Time` keeps a pointer to each scheduled `Invocation`, and the callback usually captures its owner's `this`
+	Invocation(const Invocation& other) = delete;
+	Invocation(Invocation&& other) = delete;
+	auto operator=(const Invocation& other) -> Invocation& = delete;
+	auto operator=(Invocation&& other) -> Invocation& = delete;
 	~Invocation();
 
 	void Invoke(long time, Measurement measurement);
 	void Cancel();
+
+	[[nodiscard]] auto GetTimePassed() const -> long;
+
+private:
+	static constexpr size_t notScheduled = std::numeric_limits<size_t>::max();
+
+	long m_start = 0; // `Time::m_invocationsClock` when invoked
+	unsigned long m_order = 0; // `Time::m_invocationsCounter` when invoked
+	size_t m_heapIndex = notScheduled; // Index in `Time::m_invocations`, or `notScheduled`
+
+	friend class Time;
 };
\ No newline at end of file
@@ -20,16 +20,22 @@
 
 #include "time.hpp"
 #include "invocation.hpp"
+#include "../engine.hpp"
 
-#include <algorithm>
 #include <thread>
+#ifndef _WIN32
+#include <cerrno>
+#include <ctime>
+#endif
 
 /*!
 	@fn `Time::CallInvocations`
 
 	@brief Call callback functions of finished `Invocation`s.
 
-	Progresses all `Invocation`s by `Time::deltaTime`, and calls those which waited their time.
+	Progresses all `Invocation`s by `Time::deltaTime`, and calls those which waited their time, in the order they are due (and those which are due at the same time, in the order they were invoked).
+
+	Active `Invocation`s are kept sorted by due time, so only the due ones are touched; having many `Invocation`s waiting (like `Animation`s and cooldowns) costs nothing per tick.
 
 	Normally placed at the start of your game loop, among the other callback-calling functions. For example:
 
@@ -50,37 +56,98 @@
 */
 void KTech::Time::CallInvocations()
 {
-	// ERASE-REMOVE `Invocation`s which were set to `nullptr` by `Time::DeregisterInvocation()` (which was called by `Invocation::~Invocation()`).
-	m_invocations.erase(std::ranges::begin(std::ranges::remove(m_invocations, nullptr)), m_invocations.end());
+	const Profiler::Scope profilerScope(engine.profiler, Profiler::Phase::invocations);
+	m_invocationsClock += deltaTime;
+	// Invocations that are invoked meanwhile are due from the next call, and ordered after all the ones invoked until now
+	const unsigned long invokedUntilNow = m_invocationsCounter;
+	while (!m_invocations.empty()
+		&& m_invocations[0]->m_order < invokedUntilNow
+		&& m_invocations[0]->m_start + m_invocations[0]->m_duration <= m_invocationsClock)
+	{
+		KTECH_TRACE_SPAN("Time::CallInvocations invocation");
+		Invocation* invocation = m_invocations[0];
+		Unschedule(invocation);
+		// PREVENT from calling again (and INFORM user that the invocation is inactive):
+		invocation->m_timePassed = m_invocationsClock - invocation->m_start;
+		invocation->m_active = false;
+		// CALL invoked function (which may invoke, cancel or destroy any invocation):
+		if (invocation->m_callback())
+		{
+			// INFORM `Output` to render-on-demand:
+			m_changedThisTick = true;
+			engine.profiler.AddRenderCause(Profiler::RenderCauseSource::invocation);
+		}
+	}
+}
+
+/*!
+	@brief Check whether another tick should be simulated in the current game loop iteration.
 
-	// ADVANCE all invocations:
-	// NOLINTNEXTLINE(modernize-loop-convert) // Avoid iterator invalidation (`Invocation::Advance()` can insert into `m_invocations`).
-	for (size_t i = 0; i < m_invocations.size(); i++)
+	Meant to wrap the simulation part of your game loop:
+
+	@code{.cpp}
+	// Game loop
+	while (engine.running)
 	{
-		// SKIP invocations deleted meanwhile
-		if (m_invocations[i] == nullptr)
+		engine.input.CallCallbacks();
+		while (engine.time.Step()) // <- Simulate as many ticks as due
 		{
-			continue;
+			engine.time.CallInvocations();
+			engine.memory.CallOnTicks();
 		}
 
-		if (m_invocations[i]->m_active)
+		// Graphics...
+		engine.time.WaitUntilNextTick();
+	}
+	@endcode
+
+	If `Time::fixedTimestep` is `false`, this function simply returns `true` once per game loop iteration, so a game loop written like this behaves as usual.
+
+	If `Time::fixedTimestep` is `true`, ticks are simulated at exactly `Time::tpsLimit` per second, regardless of how often the game loop iterates (which `Time::WaitUntilNextTick()` limits by `Time::fpsLimit` in this mode). This function returns `true` as long as there's time that passed and wasn't simulated yet, in whole ticks (up to `Time::maxStepsPerFrame` times a game loop iteration). `Time::deltaTime` is always exactly a tick's duration, so the simulation is deterministic even if the game loop is slow (like when printing over a slow remote session), and `Time::ticksCounter` counts the simulated ticks. `Time::tps` and `Time::tpsPotential` are measured in simulated ticks as well.
+
+	@return `true`: simulate a tick. `false`: continue to graphics.
+
+	@see `Time::fixedTimestep`
+*/
+auto KTech::Time::Step() -> bool
+{
+	if (!fixedTimestep)
+	{
+		m_stepping = !m_stepping;
+		return m_stepping;
+	}
+	const long stepDuration = 1000000 / tpsLimit;
+	// The previous step ended
+	if (m_stepping)
+	{
+		ticksCounter++;
+	}
+	else
+	{
+		// First call of this game loop iteration: add the time that passed since the last one
+		const auto now = std::chrono::steady_clock::now();
+		if (m_lastAccumulation.time_since_epoch().count() == 0)
 		{
-			// ADVANCE invocation:
-			m_invocations[i]->m_timePassed += engine.time.deltaTime;
-
-			if (m_invocations[i]->m_timePassed >= m_invocations[i]->m_duration) // Invocation is due.
-			{
-				// PREVENT from calling again (and INFORM user that the invocation is inactive):
-				m_invocations[i]->m_active = false;
-				// CALL invoked function:
-				if (m_invocations[i]->m_callback())
-				{
-					// INFORM `Output` to render-on-demand:
-					m_changedThisTick = true;
-				}
-			}
+			m_accumulated = stepDuration; // Start with a tick right away
 		}
+		else
+		{
+			m_accumulated += std::chrono::duration_cast<std::chrono::microseconds>(now - m_lastAccumulation).count();
+		}
+		m_lastAccumulation = now;
+	}
+	if (m_accumulated >= stepDuration && m_frameSteps < maxStepsPerFrame)
+	{
+		m_accumulated -= stepDuration;
+		m_frameSteps++;
+		deltaTime = stepDuration;
+		m_stepping = true;
+		return true;
 	}
+	// Drop the backlog that exceeded `maxStepsPerFrame`
+	m_accumulated %= stepDuration;
+	m_stepping = false;
+	return false;
 }
 
 /*!
@@ -88,7 +155,13 @@ void KTech::Time::CallInvocations()
 
 	@brief Sleeps and returns when the next tick should start.
 
-	Calculates how long to sleep (based on how long the current tick is, and `Time::tpsLimit`). It enters sleep and returns when the following tick should occur. This function also updates `Time::tpsPotential`, `Time::deltaTime`, `Time::tps`, and `Time::ticksCounter`.
+	Calculates how long to sleep (based on how long the current tick is, and `Time::tpsLimit`). It enters sleep and returns when the following tick should occur.
+
+	If `Time::fixedTimestep` is `true`, this function limits game loop iterations according to `Time::fpsLimit` instead, and ticks are counted by `Time::Step()`.
+
+	If `Time::idleMode` is `true` (and `Time::fixedTimestep` is `false`), then after sleeping for the rest of the tick, this function checks whether the game is idle: no world structure's `OnTick()` is subscribed to `Memory::CallOnTicks()` (i.e., they all use the default implementation, or are `Object`s that are inactive or hibernating, like pooled ones), no deferred collision events wait for `Collision::CallEvents()` (see `Collision::deferEvents`), and no function requested a render that `Output::ShouldRenderThisTick()` didn't handle yet. If so, nothing can change until the next input or the next due `Invocation`, so this function keeps waiting until the earlier of the two, without waking up in between (up to `Time::maxIdleMicroseconds`). This makes idle games (like in menus, or turn-based games waiting for the player) use nearly no CPU time. Waiting for input requires the input loop thread, so in no-game-loop mode, only the next due `Invocation` ends the wait. Not implemented in Windows, where this variable has no effect. Idle waits lower `Time::tps` and lengthen `Time::deltaTime` accordingly.
+
+	If `Time::absolutePacing` is `true`, ticks are instead scheduled at absolute deadlines (the previous deadline plus the tick duration), and this function sleeps until the next one (on POSIX, using `clock_nanosleep()` with an absolute time), optionally busy-waiting the last `Time::spinMicroseconds`. Because the deadlines don't depend on when the sleep actually ended, oversleeping in one tick is compensated for in the next, and the average TPS matches `Time::tpsLimit`. How late each tick starts is reported in `Time::jitter` and `Time::averageJitter`. If the game falls behind by more than a whole tick (e.g., the process was suspended), the deadlines restart from now, rather than running a burst of short ticks to catch up. This function also updates `Time::tpsPotential`, `Time::deltaTime`, `Time::tps`, and `Time::ticksCounter`.
 
 	Normally placed at the end of your game loop:
 
@@ -110,25 +183,143 @@ void KTech::Time::CallInvocations()
 */
 void KTech::Time::WaitUntilNextTick()
 {
+	if (fixedTimestep)
+	{
+		WaitUntilNextFrame();
+		return;
+	}
 	// Calculate delta of current tick (`deltaTime`)
 	deltaTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_currentTickStart).count();
 	// Calculate `tpsPotential`
 	tpsPotential = 1000000.0F / deltaTime;
-	// Calculate sleep duration according to `tpsLimit`
-	auto sleepDuration = std::chrono::microseconds(1000000 / tpsLimit) - std::chrono::microseconds(deltaTime);
-	// Sleep only if needed
-	if (sleepDuration.count() > 0)
+	SleepRestOf(tpsLimit);
+	if (idleMode)
 	{
-		std::this_thread::sleep_for(sleepDuration);
+		WaitWhileIdle();
 	}
 	// Calculate (actual) `tps`
 	deltaTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_currentTickStart).count();
 	tps = 1000000.0F / deltaTime;
+	engine.profiler.EndIteration();
 	// Set `m_currentTickStart` to now
 	ticksCounter++;
 	m_currentTickStart = std::chrono::steady_clock::now();
 }
 
+// `WaitUntilNextTick()` of `fixedTimestep` mode; paces game loop iterations according to `fpsLimit`, and measures the simulated ticks.
+void KTech::Time::WaitUntilNextFrame()
+{
+	const long workDuration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_currentTickStart).count();
+	if (m_frameSteps > 0)
+	{
+		tpsPotential = m_frameSteps * 1000000.0F / workDuration;
+	}
+	SleepRestOf(fpsLimit);
+	const long frameDuration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_currentTickStart).count();
+	tps = m_frameSteps * 1000000.0F / frameDuration;
+	engine.profiler.EndIteration();
+	m_frameSteps = 0;
+	m_currentTickStart = std::chrono::steady_clock::now();
+}
+
+// If nothing can change until the next input or due invocation, wait for the earlier of them (but no longer than `maxIdleMicroseconds`).
+void KTech::Time::WaitWhileIdle()
+{
+	if (engine.memory.HasTickingStructures()
+		|| !engine.collision.m_events.empty() // Deferred collision events wait for the next `Collision::CallEvents()`
+		|| engine.input.m_changedThisTick
+		|| engine.memory.m_changedThisTick
+		|| m_changedThisTick)
+	{
+		return;
+	}
+	long timeout = maxIdleMicroseconds > 0 ? maxIdleMicroseconds : -1;
+	if (!m_invocations.empty())
+	{
+		// The next `CallInvocations()` will progress the invocations by the time since `m_currentTickStart`
+		const long untilDue = m_invocations[0]->m_start + m_invocations[0]->m_duration - m_invocationsClock
+			- std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_currentTickStart).count();
+		if (untilDue <= 0)
+		{
+			return;
+		}
+		if (timeout < 0 || untilDue < timeout)
+		{
+			timeout = untilDue;
+		}
+	}
+	const Profiler::Scope profilerScope(engine.profiler, Profiler::Phase::sleep);
+	engine.input.WaitForInput(timeout);
+}
+
+// Sleep for the rest of the current tick (or frame) according to the given rate (per second).
+void KTech::Time::SleepRestOf(unsigned long p_rate)
+{
+	const Profiler::Scope profilerScope(engine.profiler, Profiler::Phase::sleep);
+	if (absolutePacing)
+	{
+		WaitUntilDeadline(p_rate);
+		return;
+	}
+	// Calculate sleep duration according to the rate
+	auto sleepDuration = std::chrono::microseconds(1000000 / p_rate) - std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_currentTickStart);
+	// Sleep only if needed
+	if (sleepDuration.count() > 0)
+	{
+		std::this_thread::sleep_for(sleepDuration);
+	}
+}
+
+// Sleep (and spin) until `m_nextTickDeadline`, then set the following deadline (according to the given rate per second) and report jitter.
+void KTech::Time::WaitUntilDeadline(unsigned long p_rate)
+{
+	const auto tickDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / p_rate));
+	auto now = std::chrono::steady_clock::now();
+	if (m_nextTickDeadline.time_since_epoch().count() == 0 || now - m_nextTickDeadline > tickDuration)
+	{
+		// First tick, or fell behind too much: start from here
+		m_nextTickDeadline = m_currentTickStart + tickDuration;
+		if (m_nextTickDeadline < now)
+		{
+			m_nextTickDeadline = now;
+		}
+	}
+	SleepUntil(m_nextTickDeadline - std::chrono::microseconds(spinMicroseconds));
+	do
+	{
+		now = std::chrono::steady_clock::now();
+	}
+	while (now < m_nextTickDeadline);
+	jitter = std::chrono::duration_cast<std::chrono::microseconds>(now - m_nextTickDeadline).count();
+	averageJitter += (jitter - averageJitter) / 16;
+	m_nextTickDeadline += tickDuration;
+}
+
+// Sleep until an absolute time of `std::chrono::steady_clock`.
+void KTech::Time::SleepUntil(std::chrono::steady_clock::time_point p_time)
+{
+#ifdef _WIN32
+	std::this_thread::sleep_until(p_time);
+#else
+	// `std::chrono::steady_clock` is `CLOCK_MONOTONIC` on POSIX
+	const auto sinceEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(p_time.time_since_epoch()).count();
+	if (sinceEpoch <= 0)
+	{
+		return;
+	}
+	timespec time{};
+	time.tv_sec = static_cast<time_t>(sinceEpoch / 1000000000);
+	time.tv_nsec = static_cast<long>(sinceEpoch % 1000000000);
+	// Repeat if interrupted by a signal
+	int result = 0;
+	do
+	{
+		result = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &time, nullptr);
+	}
+	while (result == EINTR);
+#endif
+}
+
 auto KTech::Time::TimeToMicroseconds(long p_time, Measurement p_measurement) const -> long
 {
 	switch (p_measurement)
@@ -156,12 +347,87 @@ auto KTech::Time::TimeToMicroseconds(long p_time, Measurement p_measurement) con
 	}
 }
 
-void KTech::Time::RegisterCallback(Invocation* p_invocation)
+// Add an invocation to the heap, or reposition it if it's already there.
+void KTech::Time::Schedule(Invocation* p_invocation)
+{
+	if (p_invocation->m_heapIndex == Invocation::notScheduled)
+	{
+		m_invocations.push_back(p_invocation);
+		p_invocation->m_heapIndex = m_invocations.size() - 1;
+	}
+	SiftUp(p_invocation->m_heapIndex);
+	SiftDown(p_invocation->m_heapIndex);
+}
+
+// Remove an invocation from the heap, if it's there.
+void KTech::Time::Unschedule(Invocation* p_invocation)
+{
+	const size_t index = p_invocation->m_heapIndex;
+	if (index == Invocation::notScheduled)
+	{
+		return;
+	}
+	p_invocation->m_heapIndex = Invocation::notScheduled;
+	Invocation* last = m_invocations.back();
+	m_invocations.pop_back();
+	if (last != p_invocation)
+	{
+		Place(last, index);
+		SiftUp(index);
+		SiftDown(last->m_heapIndex);
+	}
+}
+
+// Whether `p_invocation1` is due before `p_invocation2`.
+auto KTech::Time::IsEarlier(const Invocation* p_invocation1, const Invocation* p_invocation2) -> bool
+{
+	const long due1 = p_invocation1->m_start + p_invocation1->m_duration;
+	const long due2 = p_invocation2->m_start + p_invocation2->m_duration;
+	return due1 != due2 ? due1 < due2 : p_invocation1->m_order < p_invocation2->m_order;
+}
+
+void KTech::Time::Place(Invocation* p_invocation, size_t p_index)
+{
+	m_invocations[p_index] = p_invocation;
+	p_invocation->m_heapIndex = p_index;
+}
+
+void KTech::Time::SiftUp(size_t p_index)
 {
-	m_invocations.push_back(p_invocation);
+	Invocation* invocation = m_invocations[p_index];
+	while (p_index > 0)
+	{
+		const size_t parent = (p_index - 1) / 2;
+		if (!IsEarlier(invocation, m_invocations[parent]))
+		{
+			break;
+		}
+		Place(m_invocations[parent], p_index);
+		p_index = parent;
+	}
+	Place(invocation, p_index);
 }
 
-void KTech::Time::DeregisterCallback(Invocation* p_invocation)
+void KTech::Time::SiftDown(size_t p_index)
 {
-	std::replace(m_invocations.begin(), m_invocations.end(), p_invocation, static_cast<Invocation*>(nullptr));
+	Invocation* invocation = m_invocations[p_index];
+	while (true)
+	{
+		size_t child = p_index * 2 + 1;
+		if (child >= m_invocations.size())
+		{
+			break;
+		}
+		if (child + 1 < m_invocations.size() && IsEarlier(m_invocations[child + 1], m_invocations[child]))
+		{
+			child++;
+		}
+		if (!IsEarlier(m_invocations[child], invocation))
+		{
+			break;
+		}
+		Place(m_invocations[child], p_index);
+		p_index = child;
+	}
+	Place(invocation, p_index);
 }
\ No newline at end of file
@@ -25,6 +25,7 @@
 #undef KTECH_DEFINITION
 
 #include <chrono>
+#include <vector>
 
 /*!
 	@brief Engine component responsible for game loop timing.
@@ -50,22 +51,48 @@ public:
 	float tpsPotential = 0; //!< Ticks per second if it wasn't limited by `Time::tpsLimit`.
 	long deltaTime = 0; //!< Duration of the last tick, in microseconds.
 	unsigned long ticksCounter = 0; //!< Total ticks since game started.
+	bool absolutePacing = false; //!< `true`: `Time::WaitUntilNextTick()` waits until absolute deadlines, one tick duration apart, so oversleeping doesn't accumulate into lower TPS. `false` (default): it sleeps for the rest of the tick duration, relative to the current tick's start.
+	long spinMicroseconds = 0; //!< When `Time::absolutePacing` is `true`: how many microseconds before each deadline to stop sleeping and busy-wait instead, for precision (costs CPU time).
+	long jitter = 0; //!< When `Time::absolutePacing` is `true`: how late (in microseconds) the last tick started compared to its deadline.
+	float averageJitter = 0; //!< When `Time::absolutePacing` is `true`: moving average of `Time::jitter`.
+	bool fixedTimestep = false; //!< `true`: ticks are simulated at exactly `Time::tpsLimit` per second (with a constant `Time::deltaTime`), decoupled from game loop iterations ("frames"), which are limited by `Time::fpsLimit` instead. See `Time::Step()`. `false` (default): a tick is a game loop iteration.
+	unsigned long fpsLimit = 15; //!< When `Time::fixedTimestep` is `true`: max game loop iterations (and so renders and prints) allowed to occur in a second.
+	unsigned long maxStepsPerFrame = 5; //!< When `Time::fixedTimestep` is `true`: max ticks simulated in a single game loop iteration; if the game falls behind further, the rest of the backlog is dropped (slowing down the game, rather than freezing it).
+	bool idleMode = false; //!< `true`: while the game is idle, `Time::WaitUntilNextTick()` waits for input or the next due `Invocation` rather than for the next tick (see its documentation). `false` (default): ticks occur at a constant rate.
+	long maxIdleMicroseconds = 250000; //!< When `Time::idleMode` is `true`: max duration of an idle wait, so the game still notices things other than input (like the terminal being resized) every once in a while. 0 means no limit.
 
 	void CallInvocations();
+	auto Step() -> bool;
 	void WaitUntilNextTick();
 
 private:
 	bool m_changedThisTick = false;
 	Engine& engine;
-	std::chrono::steady_clock::time_point m_currentTickStart;
-	std::vector<Invocation*> m_invocations;
+	std::chrono::steady_clock::time_point m_currentTickStart{std::chrono::steady_clock::now()};
+	std::chrono::steady_clock::time_point m_nextTickDeadline; // Used if `absolutePacing` is `true`
+	std::chrono::steady_clock::time_point m_lastAccumulation; // Used if `fixedTimestep` is `true`; when `m_accumulated` was last increased
+	long m_accumulated = 0; // ^; time (microseconds) that passed and wasn't yet simulated
+	unsigned long m_frameSteps = 0; // Ticks `Step()` allowed in the current game loop iteration
+	bool m_stepping = false; // Whether `Step()` returned `true` last time
+	long m_invocationsClock = 0; // Total `deltaTime` that `CallInvocations()` progressed invocations by, in microseconds
+	unsigned long m_invocationsCounter = 0; // Counts `Invocation::Invoke()` calls, to order invocations that are due at the same time
+	std::vector<Invocation*> m_invocations; // Active invocations, as a binary min-heap ordered by due time
 
 	inline Time(Engine& engine, unsigned long ticksPerSecondLimit)
 		: engine(engine), tpsLimit(ticksPerSecondLimit) {}
 
 	[[nodiscard]] auto TimeToMicroseconds(long p_time, Measurement p_measurement) const -> long;
-	void RegisterCallback(Invocation* invocation);
-	void DeregisterCallback(Invocation* invocation);
+	void WaitUntilNextFrame();
+	void SleepRestOf(unsigned long rate);
+	void WaitWhileIdle();
+	void WaitUntilDeadline(unsigned long rate);
+	static void SleepUntil(std::chrono::steady_clock::time_point time);
+	void Schedule(Invocation* invocation);
+	void Unschedule(Invocation* invocation);
+	static auto IsEarlier(const Invocation* invocation1, const Invocation* invocation2) -> bool;
+	void Place(Invocation* invocation, size_t index);
+	void SiftUp(size_t index);
+	void SiftDown(size_t index);
 
 	friend class Invocation;
 	friend class Output;
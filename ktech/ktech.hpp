@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <cstddef> // `size_t` for `ByteRing`'s declaration
+
 namespace KTech
 {
 	// Basic structures.
@@ -42,6 +44,7 @@ namespace KTech
 	// Definitions in `world/`
 	struct Texture;
 	struct Collider;
+	struct ColliderGrid;
 	class Object;
 	class Layer;
 	class Camera;
@@ -54,6 +57,7 @@ namespace KTech
 	class Input;
 	class Memory;
 	class Output;
+	class Profiler;
 	class Time;
 	class Engine;
 	// Defined in `utility/`
@@ -64,6 +68,12 @@ namespace KTech
 	constexpr ID<T> nullID;
 	template<typename T>
 	class CachingRegistry;
+	template<typename T>
+	class ObjectPool;
+	template<size_t capacity>
+	class ByteRing;
+	class SpatialHash;
+	class WorkerPool;
 	namespace RGBColors {}
 	namespace RGBAColors {}
 	namespace Keys {}
@@ -85,6 +95,7 @@ namespace KTech
 #include "basic/cella.hpp"
 
 #include "world/collider.hpp"
+#include "world/collidergrid.hpp"
 #include "world/texture.hpp"
 #include "world/object.hpp"
 #include "world/layer.hpp"
@@ -94,16 +105,21 @@ namespace KTech
 #include "world/ui.hpp"
 
 #include "utility/animation.hpp"
+#include "utility/bytering.hpp"
 #include "utility/cachingregistry.hpp"
 #include "utility/id.hpp"
 #include "utility/keys.hpp"
+#include "utility/objectpool.hpp"
 #include "utility/rgbcolors.hpp"
 #include "utility/rgbacolors.hpp"
+#include "utility/spatialhash.hpp"
+#include "utility/workerpool.hpp"
 
 #include "engine/collision.hpp"
 #include "engine/input/input.hpp"
 #include "engine/input/callbackgroup.hpp"
 #include "engine/memory.hpp"
+#include "engine/profiler.hpp"
 #include "engine/time/time.hpp"
 #include "engine/engine.hpp"
 #endif
\ No newline at end of file
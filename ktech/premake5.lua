@@ -3,6 +3,11 @@ Create your own Premake workspace and include this file to add
 the library as a statically linkable Premake project.
 ]]--
 
+newoption {
+	trigger = "ktech-trace",
+	description = "Record trace spans of KTech's hot paths (see `Profiler::WriteTrace()`)"
+}
+
 project "KTechLibrary"
 	kind "StaticLib"
 	language "C++"
@@ -15,4 +20,7 @@ project "KTechLibrary"
 
 	filter "configurations:Debug"
 		symbols "On"
-		defines { "DEBUG" }
\ No newline at end of file
+		defines { "DEBUG" }
+
+	filter "options:ktech-trace"
+		defines { "KTECH_TRACE" }
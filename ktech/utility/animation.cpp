@@ -59,6 +59,7 @@ auto KTech::Animation::Play() -> bool
 			case Instruction::Type::ParentSetPosition:
 			{
 				engine.memory.objects[m_object]->m_pos = m_instructions[m_i].pointData;
+				engine.memory.objects[m_object]->UpdateBounds();
 				changedThisTick = true;
 				break;
 			}
@@ -86,6 +87,7 @@ auto KTech::Animation::Play() -> bool
 				if (m_instructions[m_i].intData < engine.memory.objects[m_object]->m_textures.size())
 				{
 					engine.memory.objects[m_object]->m_textures[m_instructions[m_i].intData].m_rPos = m_instructions[m_i].pointData;
+					engine.memory.objects[m_object]->UpdateBounds(); // The extent matters for hibernation
 				}
 				changedThisTick = true;
 				break;
@@ -95,6 +97,7 @@ auto KTech::Animation::Play() -> bool
 				if (m_instructions[m_i].intData < engine.memory.objects[m_object]->m_textures.size())
 				{
 					engine.memory.objects[m_object]->m_textures[m_instructions[m_i].intData].m_rPos += m_instructions[m_i].pointData;
+					engine.memory.objects[m_object]->UpdateBounds(); // The extent matters for hibernation
 				}
 				changedThisTick = true;
 				break;
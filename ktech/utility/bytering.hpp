@@ -0,0 +1,105 @@
+/*
+	KTech, Kaup's C++ 2D terminal game engine library.
+	Copyright (C) 2023-2025 Ethan Kaufman (AKA Kaup)
+
+	This file is part of KTech.
+
+	KTech is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	any later version.
+
+	KTech is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with KTech. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#define KTECH_DEFINITION
+#include "../ktech.hpp"
+#undef KTECH_DEFINITION
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/*!
+	@brief Fixed-size, lock-free queue of bytes between a single producer thread and a single consumer thread.
+
+	`Input` uses it to pass inputs from the input loop thread to `Input::CallCallbacks()` without locking or allocating memory per input.
+
+	Writes and reads are all-or-nothing, so a message written with a single `ByteRing::Write()` call is never seen partially by the consumer.
+
+	@tparam capacity Size of the buffer, in bytes. Must be a power of 2.
+*/
+template<size_t capacity>
+class KTech::ByteRing
+{
+	static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0, "`ByteRing`'s capacity must be a power of 2.");
+
+public:
+	/*!
+		@brief Add bytes to the end of the queue. Only the producer thread may call this.
+
+		@param data Bytes to add.
+		@param size Number of bytes to add.
+
+		@return `true`: added. `false`: not enough free space, so nothing was added.
+	*/
+	auto Write(const char* data, size_t size) -> bool
+	{
+		const size_t head = m_head.load(std::memory_order_relaxed);
+		if (capacity - (head - m_tail.load(std::memory_order_acquire)) < size)
+		{
+			return false;
+		}
+		for (size_t i = 0; i < size; i++)
+		{
+			m_buffer[(head + i) & (capacity - 1)] = data[i];
+		}
+		m_head.store(head + size, std::memory_order_release);
+		return true;
+	}
+
+	/*!
+		@brief Remove bytes from the start of the queue. Only the consumer thread may call this.
+
+		@param [out] data Where to copy the removed bytes to.
+		@param size Number of bytes to remove.
+
+		@return `true`: removed. `false`: there are fewer bytes in the queue, so nothing was removed.
+	*/
+	auto Read(char* data, size_t size) -> bool
+	{
+		const size_t tail = m_tail.load(std::memory_order_relaxed);
+		if (m_head.load(std::memory_order_acquire) - tail < size)
+		{
+			return false;
+		}
+		for (size_t i = 0; i < size; i++)
+		{
+			data[i] = m_buffer[(tail + i) & (capacity - 1)];
+		}
+		m_tail.store(tail + size, std::memory_order_release);
+		return true;
+	}
+
+	/*!
+		@brief Check whether the queue is empty. Only the consumer thread may call this.
+		@return `true`: there are no bytes to read. `false`: there are.
+	*/
+	[[nodiscard]] auto IsEmpty() const -> bool
+	{
+		return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::array<char, capacity> m_buffer{};
+	alignas(64) std::atomic<size_t> m_head = 0; // Total bytes written; on its own cache line, so the threads don't invalidate each other's
+	alignas(64) std::atomic<size_t> m_tail = 0; // Total bytes read
+};
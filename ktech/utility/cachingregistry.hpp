@@ -25,6 +25,8 @@
 #undef KTECH_DEFINITION
 
 #include <cstddef>
+#include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 /*!
@@ -36,9 +38,9 @@
 	>
 	> I chose to register pointers rather than store instances, and `KTech::CachingRegistry` is implementation. Its purpose is to retrieve a registered world structure pointer, given a corresponding UUID. As its name suggests, it doesn't simply iterate through all registered world structures and retrieves the one that has the matching UUID, but rather, it uses some kind of caching-related optimization.
 	>
-	> `KTech::ID` doesn't only comprise a UUID value: it also has an index (`ID::m_i`). This member is used by `CachingRegistry` to cache the last known index in the registry of the associated world structure. When `CachingRegistry` attempts to retrieve a world structure pointer, it first checks if the UUID of the given `ID` matches the UUID of the world structure registered at the given cached index. Optimally they match, so it simply returns the pointer from the cached index. If they don't, it iterates down the registry until it finds the matching UUID (i.e. the wanted world structure).
+	> `KTech::ID` doesn't only comprise a UUID value: it also has an index (`ID::m_i`). This member is used by `CachingRegistry` to cache the slot in the registry of the associated world structure. `CachingRegistry` is a "slot map": each registered world structure gets a slot, which doesn't change until the world structure is removed (removing a world structure frees its slot, without moving other world structures to other slots; freed slots are reused by world structures registered later). Each slot also stores the UUID of its world structure. When `CachingRegistry` attempts to retrieve a world structure pointer, it first checks if the UUID of the given `ID` matches the UUID stored at the given cached slot. Optimally they match, so it simply returns the pointer from the cached slot. If they don't (e.g., the `ID` was deserialized, or its world structure was removed and the slot was reused), it finds the slot of the UUID in a hash table. Either way, retrieving, registering and removing world structures take constant time, regardless of how many world structures are registered or were removed. UUIDs are never reused, so they also serve as "generations" for the slots: an `ID` of a removed world structure never matches the world structure that reused its slot.
 	>
-	> `CachingRegistry` will update the cached index of any `ID` it receives, expediting future usages of that `ID`. The cached index of `ID` is declared `mutable`, which is how `CachingRegistry` can modify it even though it asks for const-references of `ID`s.
+	> `CachingRegistry` will update the cached slot of any `ID` it receives, expediting future usages of that `ID`. The cached slot of `ID` is declared `mutable`, which is how `CachingRegistry` can modify it even though it asks for const-references of `ID`s.
 	>
 	> Additionally, considering KTech is designed to work single threaded, keeping a direct pointer to a world structure retrieved from `CachingRegistry` for the duration of a single function, after validating it (using `CachingRegistry::Exists()` or checking that the returned pointer is not `nullptr`), is valid practice, as nothing external should erase the pointed world structure from memory in the meantime.
 
@@ -51,56 +53,100 @@ public:
 	/*!
 		@brief Retrieve structure using its `ID`.
 
-		@param [in,out] id The structure's `ID`. Updates its cached index if it's stale.
+		@param [in,out] id The structure's `ID`. Updates its cached slot if it's stale.
 
 		@return Pointer to the structure.
 		@return `nullptr` if the structure was not found.
 	*/
 	auto operator[](const ID<T>& id) -> T*
 	{
-		if (!m_vec.empty())
-		{
-			for (size_t i = (id.m_i < m_vec.size() ? id.m_i : m_vec.size() - 1);; i--)
-			{
-				if (m_vec[i]->m_id == id)
-				{
-					id.m_i = i;
-					return m_vec[i];
-				}
-				if (i == 0)
-				{
-					break;
-				}
-			}
-		}
-		id.m_i = 0;
-		return nullptr;
+		size_t slot = IDToSlot(id);
+		return slot == m_slots.size() ? nullptr : m_slots[slot].structure;
 	}
 
 	/*!
 		@brief Check if an `ID` matches a registered structure.
 
-		@param [in,out] id The structure's `ID`. Updates its cached index if it's stale.
+		@param [in,out] id The structure's `ID`. Updates its cached slot if it's stale.
 
 		@return `true`: the structure exists.
 		@return `false`: ther structure doesn't exist.
 	*/
 	auto Exists(const ID<T>& id) -> bool
 	{
-		return IDToIndex(id) != m_vec.size();
+		return IDToSlot(id) != m_slots.size();
+	}
+
+	/*!
+		@brief Retrieve structure using its `ID`, without updating the `ID`'s cached slot.
+
+		Unlike the non-const overload, this one doesn't write to the given `ID`, so multiple threads can use it at the same time (as long as no thread adds or removes structures meanwhile). A stale cached slot costs a hash table lookup on every call, rather than only on the first.
+
+		@param id The structure's `ID`.
+
+		@return Pointer to the structure.
+		@return `nullptr` if the structure was not found.
+	*/
+	auto operator[](const ID<T>& id) const -> T*
+	{
+		size_t slot = FindSlot(id);
+		return slot == m_slots.size() ? nullptr : m_slots[slot].structure;
+	}
+
+	/*!
+		@brief Check if an `ID` matches a registered structure, without updating the `ID`'s cached slot.
+
+		@param id The structure's `ID`.
+
+		@return `true`: the structure exists.
+		@return `false`: ther structure doesn't exist.
+
+		@see The const overload of `operator[]`
+	*/
+	auto Exists(const ID<T>& id) const -> bool
+	{
+		return FindSlot(id) != m_slots.size();
 	}
 
 private:
-	std::vector<T*> m_vec;
+	struct Slot
+	{
+		T* structure = nullptr; // `nullptr` if the slot is free
+		uint64_t uuid = 0; // UUID of `structure`; 0 (the null `ID`'s UUID) if the slot is free
+		bool ticking = false; // Whether `structure`'s `OnTick()` should be called
+	};
+	// Entry of `m_ticking`
+	struct Ticking
+	{
+		size_t slot;
+		uint64_t uuid; // To tell whether the slot was reused since
+	};
+
+	std::vector<Slot> m_slots; // Registered structures, at stable slots
+	std::vector<size_t> m_freeSlots; // Free slots in `m_slots`, reused by `Add()`
+	std::unordered_map<uint64_t, size_t> m_uuidToSlot; // For `ID`s whose cached slot is stale
+	std::vector<Ticking> m_ticking; // Structures whose `OnTick()` should be called (by `Memory::CallOnTicks()`), in registration order. May contain obsolete entries until `ForgetNotTicking()`.
 
 	// Adds the pointer to the container.
 	// Automatically called by objects, layers, cameras and maps for themselves.
 	// You shouldn't call this manually on a structure.
 	auto Add(T* structure) -> ID<T>
 	{
-		structure->m_id.m_i = m_vec.size();
-		m_vec.push_back(structure);
-		return m_vec[m_vec.size() - 1]->m_id;
+		size_t slot = m_slots.size();
+		if (m_freeSlots.empty())
+		{
+			m_slots.emplace_back();
+		}
+		else
+		{
+			slot = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		}
+		m_slots[slot] = {structure, structure->m_id.m_uuid, true};
+		m_uuidToSlot[structure->m_id.m_uuid] = slot;
+		m_ticking.push_back({slot, structure->m_id.m_uuid});
+		structure->m_id.m_i = slot;
+		return structure->m_id;
 	}
 
 	// Remove a structure from storage (doesn't delete it's memory).
@@ -108,38 +154,75 @@ private:
 	// Returns false if the structure is missing.
 	auto Remove(const ID<T>& id) -> bool
 	{
-		size_t toRemove = IDToIndex(id);
-		if (toRemove == m_vec.size())
+		size_t toRemove = IDToSlot(id);
+		if (toRemove == m_slots.size())
 		{
 			return false;
 		}
-		m_vec.erase(m_vec.begin() + toRemove);
+		m_uuidToSlot.erase(id.m_uuid);
+		m_slots[toRemove] = Slot{};
+		m_freeSlots.push_back(toRemove);
 		return true;
 	}
 
-	// Returns the valid index of the ID.
-	// If the UUID is missing, return the size of the array making the index invalid.
-	auto IDToIndex(const ID<T>& id) -> size_t
+	// Returns the valid slot of the ID.
+	// If the UUID is missing, return the size of the array making the slot invalid.
+	auto IDToSlot(const ID<T>& id) -> size_t
+	{
+		// Free slots have the null ID's UUID, but also a `nullptr` structure
+		if (id.m_i < m_slots.size() && m_slots[id.m_i].uuid == id.m_uuid && m_slots[id.m_i].structure != nullptr)
+		{
+			return id.m_i;
+		}
+		auto slot = m_uuidToSlot.find(id.m_uuid);
+		if (slot == m_uuidToSlot.end())
+		{
+			id.m_i = 0;
+			return m_slots.size();
+		}
+		id.m_i = slot->second;
+		return slot->second;
+	}
+
+	// Same as `IDToSlot()`, but leaves the cached slot of the ID as is.
+	auto FindSlot(const ID<T>& id) const -> size_t
 	{
-		if (!m_vec.empty())
+		if (id.m_i < m_slots.size() && m_slots[id.m_i].uuid == id.m_uuid && m_slots[id.m_i].structure != nullptr)
 		{
-			for (size_t i = (id.m_i < m_vec.size() ? id.m_i : m_vec.size() - 1);; i--)
-			{
-				if (m_vec[i]->m_id == id)
-				{
-					id.m_i = i;
-					return i;
-				}
-				if (i == 0)
-				{
-					break;
-				}
-			}
+			return id.m_i;
 		}
-		id.m_i = 0;
-		return m_vec.size();
+		auto slot = m_uuidToSlot.find(id.m_uuid);
+		return slot == m_uuidToSlot.end() ? m_slots.size() : slot->second;
+	}
+
+	// Stop calling the structure's `OnTick()`.
+	// Called by the default `OnTick()` implementations, so structures that didn't override `OnTick()` aren't iterated.
+	void StopTicking(const ID<T>& id)
+	{
+		size_t slot = IDToSlot(id);
+		if (slot != m_slots.size())
+		{
+			m_slots[slot].ticking = false;
+		}
+	}
+
+	// Returns the structure of the given `m_ticking` entry, or `nullptr` if it's obsolete (removed, or stopped ticking).
+	auto GetTicking(size_t index) const -> T*
+	{
+		const Slot& slot = m_slots[m_ticking[index].slot];
+		return slot.uuid == m_ticking[index].uuid && slot.ticking ? slot.structure : nullptr;
+	}
+
+	// Removes the obsolete entries of `m_ticking`.
+	void ForgetNotTicking()
+	{
+		std::erase_if(m_ticking, [this](const Ticking& ticking)
+		{
+			const Slot& slot = m_slots[ticking.slot];
+			return slot.uuid != ticking.uuid || !slot.ticking;
+		});
 	}
 
 	friend T;
 	friend class Memory;
-};
\ No newline at end of file
+};
@@ -25,6 +25,7 @@
 #undef KTECH_DEFINITION
 
 #include <cstddef>
+#include <functional>
 
 /*!
 	@brief Serializable world structure identifier.
@@ -67,4 +68,15 @@ private:
 
 	friend T; // Allow only world structures to call `Unique()`.
 	friend class CachingRegistry<T>;
+	friend struct std::hash<ID>;
+};
+
+//! @brief Hash an `ID` by its UUID, so it can be used as a key of unordered containers.
+template<typename T>
+struct std::hash<KTech::ID<T>>
+{
+	auto operator()(const KTech::ID<T>& id) const noexcept -> size_t
+	{
+		return std::hash<uint64_t>{}(id.m_uuid);
+	}
 };
\ No newline at end of file
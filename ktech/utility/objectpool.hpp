@@ -0,0 +1,134 @@
+/*
+	KTech, Kaup's C++ 2D terminal game engine library.
+	Copyright (C) 2023-2025 Ethan Kaufman (AKA Kaup)
+
+	This file is part of KTech.
+
+	KTech is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	any later version.
+
+	KTech is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with KTech. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#define KTECH_DEFINITION
+#include "../ktech.hpp"
+#undef KTECH_DEFINITION
+#include "id.hpp"
+#include "../basic/point.hpp"
+#include "../world/object.hpp"
+
+#include <cstddef>
+#include <deque>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/*!
+	@brief Preallocated set of `Object`s that are spawned and despawned by activating and deactivating them.
+
+	Constructing and destroying an `Object` costs a heap allocation, registering it in `Memory`, and entering and leaving a `Layer`. That's significant for short-lived `Object`s that are created in large numbers (like bullets and particles). `ObjectPool` constructs all of its `Object`s in advance, inactive (`Object::m_active` is `false`), and keeps them registered and in their `Layer`s. `ObjectPool::Spawn()` activates a free `Object`, and `ObjectPool::Despawn()` deactivates it back, both without allocating memory.
+
+	Inactive `Object`s are skipped in rendering, collision and `Memory::CallOnTicks()`.
+
+	The `ObjectPool` owns its `Object`s, and destroys them when it is destroyed.
+
+	@tparam T `Object`, or a class inheriting from it.
+*/
+template<typename T>
+class KTech::ObjectPool
+{
+	static_assert(std::is_base_of_v<Object, T>, "`ObjectPool` can only contain `Object`s.");
+
+public:
+	/*!
+		@brief Construct an `ObjectPool` and all of its `Object`s.
+
+		@param capacity How many `Object`s to construct.
+		@param args Arguments for the constructor of each `Object` (for example, the `Engine` and the `Layer` to enter).
+	*/
+	template<typename... Args>
+	ObjectPool(size_t capacity, Args&&... args)
+	{
+		m_free.reserve(capacity);
+		m_indices.reserve(capacity);
+		for (size_t i = 0; i < capacity; i++)
+		{
+			T& object = m_objects.emplace_back(args...);
+			object.m_active = false;
+			object.UpdateBounds();
+			m_indices.emplace(object.m_id, i);
+			m_free.push_back(capacity - 1 - i); // So the first `Object`s are spawned first
+		}
+	}
+
+	/*!
+		@brief Activate a free `Object` at the given position.
+
+		The `Object` keeps the rest of its state from when it was despawned (or constructed), so reset what you need through the returned pointer.
+
+		@param position World position to place the `Object` at.
+
+		@return Pointer to the spawned `Object`.
+		@return `nullptr` if all the `Object`s are already spawned.
+	*/
+	auto Spawn(Point position) -> T*
+	{
+		if (m_free.empty())
+		{
+			return nullptr;
+		}
+		T& object = m_objects[m_free.back()];
+		m_free.pop_back();
+		object.m_pos = position;
+		object.m_active = true;
+		object.UpdateBounds();
+		return &object;
+	}
+
+	/*!
+		@brief Deactivate a spawned `Object`, so it can be spawned again.
+
+		@param object `ID` of the `Object` to despawn.
+
+		@return `true` if despawned. `false` if the `Object` isn't in this `ObjectPool`, or isn't spawned.
+	*/
+	auto Despawn(const ID<Object>& object) -> bool
+	{
+		auto index = m_indices.find(object);
+		if (index == m_indices.end() || !m_objects[index->second].m_active)
+		{
+			return false;
+		}
+		m_objects[index->second].m_active = false;
+		m_objects[index->second].UpdateBounds();
+		m_free.push_back(index->second);
+		return true;
+	}
+
+	//! @brief Get how many `Object`s are spawned.
+	[[nodiscard]] auto GetSpawnedCount() const -> size_t
+	{
+		return m_objects.size() - m_free.size();
+	}
+
+	//! @brief Get the total number of `Object`s.
+	[[nodiscard]] auto GetCapacity() const -> size_t
+	{
+		return m_objects.size();
+	}
+
+private:
+	std::deque<T> m_objects; // Doesn't relocate its elements (`Object`s are registered by address)
+	std::vector<size_t> m_free; // Indices of inactive `Object`s in `m_objects`
+	std::unordered_map<ID<Object>, size_t> m_indices; // `Object` `ID`s to indices in `m_objects`
+};
@@ -0,0 +1,187 @@
+/*
+	KTech, Kaup's C++ 2D terminal game engine library.
+	Copyright (C) 2023-2025 Ethan Kaufman (AKA Kaup)
+
+	This file is part of KTech.
+
+	KTech is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	any later version.
+
+	KTech is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with KTech. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "spatialhash.hpp"
+
+#include <algorithm>
+#include <utility>
+
+/*!
+	@brief Register or re-register an `Object` with its current bounds.
+
+	Does nothing if the `Object` is already registered and its bounds still touch the same cells.
+
+	@param object The `Object`'s `ID`.
+	@param start Top-left corner of the bounds (inclusive).
+	@param end Bottom-right corner of the bounds (exclusive).
+*/
+void KTech::SpatialHash::Update(const ID<Object>& p_object, Point p_start, Point p_end)
+{
+	Entry entry{p_object, m_nextOrder, Point(CellOf(p_start.x), CellOf(p_start.y)), Point(CellOf(p_end.x - 1), CellOf(p_end.y - 1))};
+	auto it = m_entries.find(p_object);
+	if (it != m_entries.end())
+	{
+		if (it->second.start == entry.start && it->second.end == entry.end)
+		{
+			// Still in the same cells
+			return;
+		}
+		// Keep the original order, so the `Object` keeps its place in query results
+		entry.order = it->second.order;
+		Erase(it->second);
+		it->second = entry;
+	}
+	else
+	{
+		m_nextOrder++;
+		if (m_spareEntries.empty())
+		{
+			m_entries.emplace(p_object, entry);
+		}
+		else
+		{
+			m_spareEntries.back().key() = p_object;
+			m_spareEntries.back().mapped() = entry;
+			m_entries.insert(std::move(m_spareEntries.back()));
+			m_spareEntries.pop_back();
+		}
+	}
+	Insert(entry);
+	m_version++;
+}
+
+/*!
+	@brief Unregister an `Object`.
+	@param object The `Object`'s `ID`.
+*/
+void KTech::SpatialHash::Remove(const ID<Object>& p_object)
+{
+	auto it = m_entries.find(p_object);
+	if (it != m_entries.end())
+	{
+		Erase(it->second);
+		m_spareEntries.push_back(m_entries.extract(it));
+		m_version++;
+	}
+}
+
+//! @brief Unregister all `Object`s.
+void KTech::SpatialHash::Clear()
+{
+	m_buckets.clear();
+	m_entries.clear();
+	m_version++;
+}
+
+/*!
+	@brief Get a number that changes whenever an `Object` is registered, unregistered, or moves to different cells.
+
+	Useful for knowing whether previous query results might be outdated.
+
+	@return The current version.
+*/
+auto KTech::SpatialHash::GetVersion() const -> size_t
+{
+	return m_version;
+}
+
+/*!
+	@brief Get the `Object`s whose bounds potentially overlap an area.
+
+	Each `Object` appears once, and in the order it was first registered.
+
+	@param start Top-left corner of the area (inclusive).
+	@param end Bottom-right corner of the area (exclusive).
+	@param [out] result Vector to append the found `Object`s to.
+*/
+void KTech::SpatialHash::Query(Point p_start, Point p_end, std::vector<ID<Object>>& p_result) const
+{
+	thread_local std::vector<const Entry*> found; // Reused, so querying doesn't allocate
+	found.clear();
+	const Point start(CellOf(p_start.x), CellOf(p_start.y));
+	const Point end(CellOf(p_end.x - 1), CellOf(p_end.y - 1));
+	for (int32_t y = start.y; y <= end.y; y++)
+	{
+		for (int32_t x = start.x; x <= end.x; x++)
+		{
+			auto bucket = m_buckets.find(Key(x, y));
+			if (bucket == m_buckets.end())
+			{
+				continue;
+			}
+			for (const Entry& entry : bucket->second)
+			{
+				// An `Object` registered in multiple cells is only reported from the first cell that both it and the area touch
+				if (x == std::max(entry.start.x, start.x) && y == std::max(entry.start.y, start.y))
+				{
+					found.push_back(&entry);
+				}
+			}
+		}
+	}
+	// Sort the found `Object`s by registration order
+	std::sort(found.begin(), found.end(), [](const Entry* p_a, const Entry* p_b)
+	{
+		return p_a->order < p_b->order;
+	});
+	for (const Entry* entry : found)
+	{
+		p_result.push_back(entry->object);
+	}
+}
+
+auto KTech::SpatialHash::CellOf(int32_t p_coordinate) const -> int32_t
+{
+	// Floor division, so negative coordinates don't share cell 0
+	return (p_coordinate >= 0 ? p_coordinate : p_coordinate - m_cellSize + 1) / m_cellSize;
+}
+
+auto KTech::SpatialHash::Key(int32_t p_x, int32_t p_y) -> uint64_t
+{
+	return (static_cast<uint64_t>(static_cast<uint32_t>(p_x)) << 32) | static_cast<uint32_t>(p_y);
+}
+
+void KTech::SpatialHash::Insert(const Entry& p_entry)
+{
+	for (int32_t y = p_entry.start.y; y <= p_entry.end.y; y++)
+	{
+		for (int32_t x = p_entry.start.x; x <= p_entry.end.x; x++)
+		{
+			m_buckets[Key(x, y)].push_back(p_entry);
+		}
+	}
+}
+
+void KTech::SpatialHash::Erase(const Entry& p_entry)
+{
+	for (int32_t y = p_entry.start.y; y <= p_entry.end.y; y++)
+	{
+		for (int32_t x = p_entry.start.x; x <= p_entry.end.x; x++)
+		{
+			auto bucket = m_buckets.find(Key(x, y));
+			if (bucket == m_buckets.end())
+			{
+				continue;
+			}
+			// Empty buckets are kept, as they are likely to be reused
+			std::erase_if(bucket->second, [&](const Entry& p_other){ return p_other.object == p_entry.object; });
+		}
+	}
+}
@@ -0,0 +1,73 @@
+/*
+	KTech, Kaup's C++ 2D terminal game engine library.
+	Copyright (C) 2023-2025 Ethan Kaufman (AKA Kaup)
+
+	This file is part of KTech.
+
+	KTech is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	any later version.
+
+	KTech is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with KTech. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#define KTECH_DEFINITION
+#include "../ktech.hpp"
+#undef KTECH_DEFINITION
+#include "id.hpp"
+#include "../basic/point.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+/*!
+	@brief Uniform spatial hash of `Object` bounds, used by `Collision` as a broad phase.
+
+	Space is divided into square cells (`SpatialHash::m_cellSize`), and each `Object` is registered in every cell its bounds (rectangle enclosing its `Collider`s) touch. Querying an area then only visits the `Object`s registered in the cells the area touches, rather than all `Object`s in the `Layer`.
+
+	Every `Layer` has one of these, which it keeps updated with its `Object`s. While `Memory::hibernation` is `true`, `Layer`s also keep a second one, of the rectangles enclosing their `Object`s' `Collider`s and `Texture`s, which `Memory` queries to find the `Object`s in the active regions. You shouldn't normally need to use this class directly.
+
+	@see `Collision::MoveObject()`
+	@see `Object::UpdateBounds()`
+*/
+class KTech::SpatialHash
+{
+public:
+	int32_t m_cellSize = 8; //!< Width and height of cells. Changing it only affects future insertions, so call `SpatialHash::Clear()` before.
+
+	void Update(const ID<Object>& object, Point start, Point end);
+	void Remove(const ID<Object>& object);
+	void Clear();
+
+	void Query(Point start, Point end, std::vector<ID<Object>>& result) const;
+	[[nodiscard]] auto GetVersion() const -> size_t;
+
+private:
+	struct Entry
+	{
+		ID<Object> object;
+		size_t order; // Insertion order, so query results keep a stable order
+		Point start; // Inclusive, in cells
+		Point end; // Inclusive, in cells
+	};
+
+	std::unordered_map<uint64_t, std::vector<Entry>> m_buckets;
+	std::unordered_map<ID<Object>, Entry> m_entries;
+	std::vector<std::unordered_map<ID<Object>, Entry>::node_type> m_spareEntries; // Nodes of removed entries, reused so registering doesn't allocate
+	size_t m_nextOrder = 0;
+	size_t m_version = 0;
+
+	[[nodiscard]] auto CellOf(int32_t coordinate) const -> int32_t;
+	static auto Key(int32_t x, int32_t y) -> uint64_t;
+	void Insert(const Entry& entry);
+	void Erase(const Entry& entry);
+};
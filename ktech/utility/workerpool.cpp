@@ -0,0 +1,129 @@
+/*
+	KTech, Kaup's C++ 2D terminal game engine library.
+	Copyright (C) 2023-2025 Ethan Kaufman (AKA Kaup)
+
+	This file is part of KTech.
+
+	KTech is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	any later version.
+
+	KTech is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with KTech. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "workerpool.hpp"
+
+#include <algorithm>
+
+//! @brief Stop and join the worker threads.
+KTech::WorkerPool::~WorkerPool()
+{
+	{
+		const std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_started.notify_all();
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+/*!
+	@brief Get the number of threads that run a batch, including the calling thread.
+	@return As many threads as the hardware supports (at least 1).
+*/
+auto KTech::WorkerPool::GetThreadsCount() const -> size_t
+{
+	return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+/*!
+	@brief Run a batch of tasks on the worker threads and the calling thread, and wait until they are all done.
+
+	Each task is run once, by whichever thread is free first, so tasks shouldn't depend on the order they run in. If a batch is already running (for example, if a task starts another batch), the tasks are run one after another on the calling thread instead.
+
+	@param tasks Number of tasks.
+	@param task Function that runs the task of the given index (from 0 to `tasks - 1`).
+*/
+void KTech::WorkerPool::Run(size_t p_tasks, const std::function<void(size_t)>& p_task)
+{
+	if (p_tasks <= 1 || GetThreadsCount() == 1 || m_busy.exchange(true))
+	{
+		for (size_t i = 0; i < p_tasks; i++)
+		{
+			p_task(i);
+		}
+		return;
+	}
+	// Created on the first batch, so engines that never run one don't have idle threads
+	if (m_threads.empty())
+	{
+		for (size_t i = 1; i < GetThreadsCount(); i++)
+		{
+			m_threads.emplace_back(&WorkerPool::Loop, this);
+		}
+	}
+	{
+		const std::lock_guard<std::mutex> lock(m_mutex);
+		m_task = &p_task;
+		m_tasks = p_tasks;
+		m_nextTask = 0;
+		m_working = m_threads.size();
+		m_batch++;
+	}
+	m_started.notify_all();
+	// The calling thread works too
+	Work();
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_finished.wait(lock, [this]{ return m_working == 0; });
+		m_task = nullptr;
+	}
+	m_busy = false;
+}
+
+// Body of the worker threads: wait for a batch, take part in it, and repeat until stopping.
+void KTech::WorkerPool::Loop()
+{
+	size_t batch = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_started.wait(lock, [&]{ return m_stopping || m_batch != batch; });
+			if (m_stopping)
+			{
+				return;
+			}
+			batch = m_batch;
+		}
+		Work();
+		bool last = false;
+		{
+			const std::lock_guard<std::mutex> lock(m_mutex);
+			m_working--;
+			last = m_working == 0;
+		}
+		if (last)
+		{
+			m_finished.notify_one();
+		}
+	}
+}
+
+// Take and run tasks of the current batch until there are none left.
+void KTech::WorkerPool::Work()
+{
+	for (size_t i = m_nextTask++; i < m_tasks; i = m_nextTask++)
+	{
+		(*m_task)(i);
+	}
+}
@@ -0,0 +1,63 @@
+/*
+	KTech, Kaup's C++ 2D terminal game engine library.
+	Copyright (C) 2023-2025 Ethan Kaufman (AKA Kaup)
+
+	This file is part of KTech.
+
+	KTech is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	any later version.
+
+	KTech is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with KTech. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#define KTECH_DEFINITION
+#include "../ktech.hpp"
+#undef KTECH_DEFINITION
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+	@brief Persistent worker threads that run batches of tasks together with the calling thread.
+
+	`Memory` keeps one, which runs the parallel `OnTick()`s (see `Object::m_parallelTick`) and `Collision::MoveObjectsParallel()`. The threads are created on the first batch, and then wait between batches, so a batch costs a wake-up rather than creating and joining threads. You shouldn't normally need to use this class directly.
+*/
+class KTech::WorkerPool
+{
+public:
+	WorkerPool() = default;
+	~WorkerPool();
+
+	[[nodiscard]] auto GetThreadsCount() const -> size_t;
+	void Run(size_t tasks, const std::function<void(size_t)>& task);
+
+private:
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex; // Protects the members below, except for `m_nextTask`
+	std::condition_variable m_started; // Notified when a batch starts (the start barrier), or when stopping
+	std::condition_variable m_finished; // Notified when the last worker finishes its part of a batch (the finish barrier)
+	const std::function<void(size_t)>* m_task = nullptr; // Task of the current batch
+	size_t m_tasks = 0; // Number of tasks in the current batch
+	std::atomic<size_t> m_nextTask = 0; // Index of the next task of the current batch that isn't taken yet
+	size_t m_batch = 0; // Incremented for each batch, so waiting workers can tell a new one started
+	size_t m_working = 0; // Workers that haven't finished their part of the current batch yet
+	bool m_stopping = false;
+	std::atomic<bool> m_busy = false; // Whether a batch is running; batches started meanwhile (e.g., from a task) run on their calling thread instead
+
+	void Loop();
+	void Work();
+};
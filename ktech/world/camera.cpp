@@ -138,16 +138,22 @@ void KTech::Camera::Render()
 */
 void KTech::Camera::Render(const std::vector<ID<Layer>>& p_layers)
 {
+	const Profiler::Scope profilerScope(engine.profiler, Profiler::Phase::cameraRender);
 	RenderBackground();
 
 	for (const KTech::ID<KTech::Layer>& layerID : p_layers)
 	{
+		KTECH_TRACE_SPAN("Camera::Render layer");
 		KTech::Layer* layer = engine.memory.layers[layerID];
 		if (layer->m_visible)
 		{
 			for (const KTech::ID<KTech::Object>& ObjectID : layer->m_objects)
 			{
 				KTech::Object* object = engine.memory.objects[ObjectID];
+				if (!object->m_active || object->IsHibernating())
+				{
+					continue;
+				}
 				for (KTech::Texture& texture : object->m_textures)
 				{
 					if (texture.m_active)
@@ -220,6 +226,8 @@ void KTech::Camera::RenderDrawPrint()
 
 	Called by `Memory::CallOnTicks()`.
 
+	Don't call the base `Camera::OnTick()` from your override; doing so stops this `Camera` from ticking (the base implementation unsubscribes it from `Memory::CallOnTicks()`).
+
 	@return `bool` value, which is explained in `Output::ShouldRenderThisTick()`.
 
 	@see `Memory::CallOnTicks()`
@@ -227,6 +235,7 @@ void KTech::Camera::RenderDrawPrint()
 */
 auto KTech::Camera::OnTick() -> bool
 {
+	engine.memory.cameras.StopTicking(m_id);
 	return false;
 };
 
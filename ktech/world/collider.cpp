@@ -87,13 +87,13 @@ void KTech::Collider::Write(const std::vector<std::string>& p_stringVector, uint
 		}
 	}
 	// Apply size
-	m_c.resize(m_size.x * m_size.y);
+	m_c.assign(GetRowWords() * m_size.y, 0);
 	// Read from strings
 	for (size_t y = 0; y < m_size.y; y++)
 	{
 		for (size_t x = 0; x < m_size.x && x < p_stringVector[y].size(); x++)
 		{
-			m_c[m_size.x * y + x] = p_stringVector[y][x] != ' ';
+			Set(x, y, p_stringVector[y][x] != ' ');
 		}
 	}
 }
@@ -114,11 +114,14 @@ void KTech::Collider::ByTextureCharacter(const Texture& p_texture, uint8_t p_typ
 	// Get size
 	m_size = p_texture.m_size;
 	// Apply size
-	m_c.resize(p_texture.m_t.size());
+	m_c.assign(GetRowWords() * m_size.y, 0);
 	// Read from texture
-	for (size_t i = 0; i < m_c.size(); i++)
+	for (size_t y = 0; y < m_size.y; y++)
 	{
-		m_c[i] = (p_texture.m_t[i].c != p_excludedCharacter);
+		for (size_t x = 0; x < m_size.x; x++)
+		{
+			Set(x, y, p_texture.m_t[m_size.x * y + x].c != p_excludedCharacter);
+		}
 	}
 }
 
@@ -138,11 +141,14 @@ void KTech::Collider::ByTextureBackground(const Texture& p_texture, uint8_t p_ty
 	// Get size
 	m_size = p_texture.m_size;
 	// Apply size
-	m_c.resize(p_texture.m_t.size());
+	m_c.assign(GetRowWords() * m_size.y, 0);
 	// Read from texture
-	for (size_t i = 0; i < m_c.size(); i++)
+	for (size_t y = 0; y < m_size.y; y++)
 	{
-		m_c[i] = (p_texture.m_t[i].b.a >= p_alphaThreshold);
+		for (size_t x = 0; x < m_size.x; x++)
+		{
+			Set(x, y, p_texture.m_t[m_size.x * y + x].b.a >= p_alphaThreshold);
+		}
 	}
 }
 
@@ -162,12 +168,76 @@ void KTech::Collider::ByTextureForeground(const Texture& p_texture, uint8_t p_ty
 	// Get size
 	m_size = p_texture.m_size;
 	// Apply size
-	m_c.resize(p_texture.m_t.size());
+	m_c.assign(GetRowWords() * m_size.y, 0);
 	// Read from texture
-	for (size_t i = 0; i < m_c.size(); i++)
+	for (size_t y = 0; y < m_size.y; y++)
+	{
+		for (size_t x = 0; x < m_size.x; x++)
+		{
+			Set(x, y, p_texture.m_t[m_size.x * y + x].f.a >= p_alphaThreshold);
+		}
+	}
+}
+
+/*!
+	@fn Collider::Set
+
+	@brief Set a value in the 2D bitmap (complex `Collider`s only).
+
+	Useful if you don't want to deal with the packed bitmap vector (`Collider::m_c`) yourself. The position must be within `Collider::m_size`.
+
+	@param x X axis.
+	@param y Y axis.
+	@param value `true` to turn the cell on, `false` to turn it off.
+*/
+void KTech::Collider::Set(size_t p_x, size_t p_y, bool p_value)
+{
+	const uint64_t bit = uint64_t{1} << (p_x % 64);
+	uint64_t& word = m_c[GetRowWords() * p_y + p_x / 64];
+	word = p_value ? (word | bit) : (word & ~bit);
+}
+
+/*!
+	@fn Collider::GetRowWords
+
+	@brief Get the amount of 64-bit words each row of the 2D bitmap takes (complex `Collider`s only).
+
+	@return `m_size.x` divided by 64, rounded up.
+*/
+auto KTech::Collider::GetRowWords() const -> size_t
+{
+	return (m_size.x + 63) / 64;
+}
+
+/*!
+	@fn Collider::GetRowBits
+
+	@brief Get 64 consecutive cells of a row in the 2D bitmap, as bits (complex `Collider`s only).
+
+	Used by `Collision` to test overlap of whole words at a time. Cells beyond the end of the row are returned off.
+
+	@param x X axis of the first cell, which will be the lowest bit.
+	@param y Y axis.
+
+	@return Bits of the cells from `x` to `x + 63`.
+*/
+auto KTech::Collider::GetRowBits(size_t p_x, size_t p_y) const -> uint64_t
+{
+	const size_t rowWords = GetRowWords();
+	const size_t wordI = p_x / 64;
+	const size_t shift = p_x % 64;
+	if (wordI >= rowWords)
+	{
+		return 0;
+	}
+	const uint64_t* row = m_c.data() + rowWords * p_y;
+	uint64_t bits = row[wordI] >> shift;
+	// Take the rest from the next word
+	if (shift != 0 && wordI + 1 < rowWords)
 	{
-		m_c[i] = (p_texture.m_t[i].b.a >= p_alphaThreshold);
+		bits |= row[wordI + 1] << (64 - shift);
 	}
+	return bits;
 }
 
 /*!
@@ -175,7 +245,7 @@ void KTech::Collider::ByTextureForeground(const Texture& p_texture, uint8_t p_ty
 
 	@brief Get a value from the 2D bitmap by-value (complex `Collider`s only).
 
-	Useful if you don't want to convert the 2D position to the corresponding index in the bitmap vector (`Collider::m_c`).
+	Useful if you don't want to deal with the packed bitmap vector (`Collider::m_c`) yourself.
 
 	@param x X axis.
 	@param y Y axis.
@@ -184,5 +254,5 @@ void KTech::Collider::ByTextureForeground(const Texture& p_texture, uint8_t p_ty
 */
 auto KTech::Collider::operator()(size_t p_x, size_t p_y) const -> bool
 {
-	return m_c[m_size.x * p_y + p_x];
+	return (m_c[GetRowWords() * p_y + p_x / 64] >> (p_x % 64)) & 1;
 }
\ No newline at end of file
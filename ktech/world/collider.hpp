@@ -36,7 +36,9 @@
 
 	Similarly to `Texture`, there are 2 forms of `Collider`s: "simple" and "complex".
 	- Simple colliders are just efficient filled rectangles, which take the least amount of processing and memory. So, you should prefer using simple `Collider`s.
-	- Complex colliders are 2D bitmaps of `bool`s which allow them to hold a detailed shape (in contrary to a filled rectangle). This makes them the least efficient in terms of processing and memory. So, minimize your use of complex `Collider`s to when you need such detailed shapes.
+	- Complex colliders are 2D bitmaps which allow them to hold a detailed shape (in contrary to a filled rectangle). This makes them less efficient in terms of processing and memory. So, minimize your use of complex `Collider`s to when you need such detailed shapes.
+
+	The bitmap of complex `Collider`s is packed into 64-bit words, where each row starts at a new word (see `Collider::m_c`). This lets `Collision` test overlap of up to 64 cells at a time.
 
 	`Collider`s also have a "type", which you can define yourself (or first learn about) in `Collision::colliderTypes`.
 
@@ -50,7 +52,7 @@ struct KTech::Collider
 	uint8_t m_type; //!< `Collider` type, which determines collision results based on `Collision::colliderTypes`.
 	Point m_rPos; //!< Relative position to the parent `Object`.
 	UPoint m_size; //!< Rectangle size (used in both simple and complex forms).
-	std::vector<bool> m_c; //!< 1D vector of the 2D bitmap (used only in complex form).
+	std::vector<uint64_t> m_c; //!< Row-aligned 2D bitmap (used only in complex form). Row `y` starts at word `y * GetRowWords()`, and cell `x` is bit `x % 64` of the row's word `x / 64`. Unused bits at the end of rows must stay off.
 
 	void Simple(UPoint size, uint8_t type, Point relativePosition = Point(0, 0));
 	void Write(const std::vector<std::string>& stringVector, uint8_t type, Point relativePosition = Point(0, 0));
@@ -58,5 +60,9 @@ struct KTech::Collider
 	void ByTextureBackground(const Texture& texture, uint8_t type, uint8_t alphaThreshold = 0);
 	void ByTextureForeground(const Texture& texture, uint8_t type, uint8_t alphaThreshold = 0);
 
+	void Set(size_t x, size_t y, bool value);
+
+	[[nodiscard]] auto GetRowWords() const -> size_t;
+	[[nodiscard]] auto GetRowBits(size_t x, size_t y) const -> uint64_t;
 	[[nodiscard]] auto operator()(size_t x, size_t y) const -> bool;
 };
\ No newline at end of file
@@ -0,0 +1,136 @@
+/*
+	KTech, Kaup's C++ 2D terminal game engine library.
+	Copyright (C) 2023-2025 Ethan Kaufman (AKA Kaup)
+
+	This file is part of KTech.
+
+	KTech is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	any later version.
+
+	KTech is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with KTech. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "collidergrid.hpp"
+
+#include "collider.hpp"
+
+#include <algorithm>
+
+/*!
+	@fn ColliderGrid::Resize
+	@brief Resize the grid and clear all of its cells.
+
+	@param size Grid size, in cells.
+	@param position World position of the top-left cell.
+*/
+void KTech::ColliderGrid::Resize(UPoint p_size, Point p_position)
+{
+	m_pos = p_position;
+	m_size = p_size;
+	m_c.assign(static_cast<size_t>(m_size.x) * m_size.y, empty);
+}
+
+/*!
+	@fn ColliderGrid::Write
+	@brief Set cells according to a string representation.
+
+	Works like `Collider::Write()`: if a character is not a space (' '), the corresponding cell is set to the given type. Spaces leave their cells unchanged. Cells outside of the grid are ignored.
+
+	@param stringVector The 2D representation in a vector of `std::string`s.
+	@param type Collider type, as defined in `Collision::colliderTypes`.
+	@param relativePosition Position relative to the top-left cell of the grid.
+*/
+void KTech::ColliderGrid::Write(const std::vector<std::string>& p_stringVector, uint8_t p_type, Point p_relativePosition)
+{
+	for (size_t y = 0; y < p_stringVector.size(); y++)
+	{
+		for (size_t x = 0; x < p_stringVector[y].size(); x++)
+		{
+			const Point cell(p_relativePosition.x + static_cast<int32_t>(x), p_relativePosition.y + static_cast<int32_t>(y));
+			if (p_stringVector[y][x] != ' '
+				&& cell.x >= 0 && cell.x < static_cast<int32_t>(m_size.x)
+				&& cell.y >= 0 && cell.y < static_cast<int32_t>(m_size.y))
+			{
+				(*this)(cell.x, cell.y) = p_type;
+			}
+		}
+	}
+}
+
+/*!
+	@fn ColliderGrid::Stamp
+	@brief Copy the shape and type of a `Collider` into the grid.
+
+	Useful for turning the `Collider`s of static `Object`s (like terrain built with `Collider::ByTextureBackground()`) into grid cells. `Collider::m_rPos` is ignored in favor of `relativePosition`. Cells outside of the grid are ignored.
+
+	@param collider The `Collider` to copy (simple or complex).
+	@param relativePosition Position relative to the top-left cell of the grid.
+*/
+void KTech::ColliderGrid::Stamp(const Collider& p_collider, Point p_relativePosition)
+{
+	for (size_t y = (p_relativePosition.y < 0 ? -p_relativePosition.y : 0); y < p_collider.m_size.y && p_relativePosition.y + y < m_size.y; y++)
+	{
+		for (size_t x = (p_relativePosition.x < 0 ? -p_relativePosition.x : 0); x < p_collider.m_size.x && p_relativePosition.x + x < m_size.x; x++)
+		{
+			if (p_collider.m_simple || p_collider(x, y))
+			{
+				(*this)(p_relativePosition.x + x, p_relativePosition.y + y) = p_collider.m_type;
+			}
+		}
+	}
+}
+
+//! @brief Set all cells to `ColliderGrid::empty`, without resizing.
+void KTech::ColliderGrid::Clear()
+{
+	std::ranges::fill(m_c, empty);
+}
+
+/*!
+	@fn ColliderGrid::operator()(size_t x, size_t y)
+	@brief Get a cell by-reference.
+	@param x X axis, relative to the top-left cell.
+	@param y Y axis, relative to the top-left cell.
+	@return Reference to the collider type of the cell.
+*/
+auto KTech::ColliderGrid::operator()(size_t p_x, size_t p_y) -> uint8_t&
+{
+	return m_c[m_size.x * p_y + p_x];
+}
+
+/*!
+	@fn ColliderGrid::operator()(size_t x, size_t y) const
+	@brief Get a cell by-value.
+	@param x X axis, relative to the top-left cell.
+	@param y Y axis, relative to the top-left cell.
+	@return The collider type of the cell.
+*/
+auto KTech::ColliderGrid::operator()(size_t p_x, size_t p_y) const -> uint8_t
+{
+	return m_c[m_size.x * p_y + p_x];
+}
+
+/*!
+	@fn ColliderGrid::Get
+	@brief Get a cell by world position.
+	@param position World position.
+	@return The collider type of the cell, or `ColliderGrid::empty` if the position is outside of the grid.
+*/
+auto KTech::ColliderGrid::Get(Point p_position) const -> uint8_t
+{
+	p_position -= m_pos;
+	if (p_position.x < 0 || p_position.x >= static_cast<int32_t>(m_size.x)
+		|| p_position.y < 0 || p_position.y >= static_cast<int32_t>(m_size.y))
+	{
+		return empty;
+	}
+	return (*this)(p_position.x, p_position.y);
+}
@@ -0,0 +1,63 @@
+/*
+	KTech, Kaup's C++ 2D terminal game engine library.
+	Copyright (C) 2023-2025 Ethan Kaufman (AKA Kaup)
+
+	This file is part of KTech.
+
+	KTech is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	any later version.
+
+	KTech is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with KTech. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#define KTECH_DEFINITION
+#include "../ktech.hpp"
+#undef KTECH_DEFINITION
+#include "../basic/point.hpp"
+#include "../basic/upoint.hpp"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+/*!
+	@brief Static 2D grid of collider types, for tilemaps and terrain.
+
+	Every `Layer` has one of these (`Layer::m_colliderGrid`), which is empty by default. Each cell of the grid holds a collider type (as defined in `Collision::colliderTypes`), or `ColliderGrid::empty` if there is no collider in that cell.
+
+	`Collision::MoveObject()` tests moving `Object`s against the grid with direct cell lookups, rather than against every other `Object` in the `Layer`. This makes the grid the most efficient way to represent large static structures (like the ground and walls of a platformer level), which would otherwise be big complex `Collider`s of some `Object`, and be processed on every movement in the `Layer`.
+
+	Cells are static: they can block and be overlapped, but they can't be pushed. So, a potential collision result of `Collision::CR::P` with a cell is treated as `Collision::CR::B`.
+
+	Since the grid is not an `Object`, collision callbacks that report it as the other party receive `nullID<Object>` as the other `Object`, and the index of the grid cell (`ColliderGrid::m_c`) as the other `Collider`.
+
+	@see `Layer::m_colliderGrid`
+	@see `Collision::MoveObject()`
+*/
+struct KTech::ColliderGrid
+{
+	static constexpr uint8_t empty = std::numeric_limits<uint8_t>::max(); //!< Value of cells without a collider.
+
+	Point m_pos; //!< World position of the top-left cell.
+	UPoint m_size; //!< Grid size, in cells.
+	std::vector<uint8_t> m_c; //!< 1D vector of the 2D grid of collider types.
+
+	void Resize(UPoint size, Point position = Point(0, 0));
+	void Write(const std::vector<std::string>& stringVector, uint8_t type, Point relativePosition = Point(0, 0));
+	void Stamp(const Collider& collider, Point relativePosition);
+	void Clear();
+
+	[[nodiscard]] auto operator()(size_t x, size_t y) -> uint8_t&;
+	[[nodiscard]] auto operator()(size_t x, size_t y) const -> uint8_t;
+	[[nodiscard]] auto Get(Point position) const -> uint8_t;
+};
@@ -21,11 +21,14 @@
 #include "layer.hpp"
 
 #include "../utility/rgbcolors.hpp"
+#include "collider.hpp"
 #include "map.hpp"
 #include "object.hpp"
 #include "../engine/output.hpp"
 #include "../engine/engine.hpp"
 
+#include <cstdlib>
+
 /*!
 	@fn Layer::Layer(Engine& engine, std::string name)
 	@brief Construct a `Layer`.
@@ -94,7 +97,14 @@ auto KTech::Layer::AddObject(const ID<Object>& p_object) -> bool
 		}
 	}
 	engine.memory.objects[p_object]->m_parentLayer = m_id;
+	engine.memory.objects[p_object]->m_hibernating = false; // Possibly set by a previous `Layer`; `Memory` decides again for this one
 	m_objects.push_back(p_object);
+	engine.memory.objects[p_object]->CacheBounds();
+	UpdateSpatialHash(*engine.memory.objects[p_object]);
+	if (engine.memory.m_trackingHibernation)
+	{
+		m_awakeObjects.push_back(p_object);
+	}
 	return true;
 }
 
@@ -113,7 +123,14 @@ auto KTech::Layer::RemoveObject(const ID<Object>& p_object) -> bool
 			if (engine.memory.objects.Exists(m_objects[i]))
 			{
 				engine.memory.objects[m_objects[i]]->m_parentLayer = nullID<Layer>;
+				if (engine.memory.objects[m_objects[i]]->m_hibernating)
+				{
+					engine.memory.objects[m_objects[i]]->m_hibernating = false; // Only `Object`s in `Layer`s hibernate
+					m_hibernatingObjects--;
+				}
 			}
+			m_spatialHash.Remove(m_objects[i]);
+			m_hibernationHash.Remove(m_objects[i]);
 			m_objects.erase(m_objects.begin() + i);
 			return true;
 		}
@@ -136,9 +153,14 @@ auto KTech::Layer::RemoveAllObjects() -> bool
 		if (engine.memory.objects.Exists(object))
 		{
 			engine.memory.objects[object]->m_parentLayer = nullID<Layer>;
+			engine.memory.objects[object]->m_hibernating = false;
 		}
 	}
 	m_objects.clear();
+	m_spatialHash.Clear();
+	m_hibernationHash.Clear();
+	m_awakeObjects.clear();
+	m_hibernatingObjects = 0;
 	return true;
 }
 
@@ -171,6 +193,110 @@ auto KTech::Layer::LeaveMap() -> bool
 	return true;
 }
 
+/*!
+	@brief Find the `Object`s that have a `Collider` overlapping a rectangle.
+
+	Uses the `Layer`'s spatial hash, so only `Object`s near the rectangle are tested. Overlap is tested the same way `Collision` does, so complex `Collider`s overlap only where their bitmap is on. `ColliderGrid` cells are not included; use `ColliderGrid::Get()` for those.
+
+	@param position Top-left corner of the rectangle.
+	@param size Size of the rectangle.
+	@param type If given, only `Collider`s of this type (`Collider::m_type`) are considered.
+
+	@return The overlapping `Object`s, in the order they were added to the `Layer` (approximately; moving between `Layer`s resets it).
+
+	@see `Layer::QueryPoint()`
+	@see `Layer::Raycast()`
+*/
+auto KTech::Layer::QueryRect(Point p_position, UPoint p_size, std::optional<uint8_t> p_type) -> std::vector<ID<Object>>
+{
+	std::vector<ID<Object>> result;
+	if (p_size.x == 0 || p_size.y == 0)
+	{
+		return result;
+	}
+	Collider area;
+	area.Simple(p_size, 0);
+	m_spatialHash.Query(p_position, p_position + p_size, result);
+	std::erase_if(result, [&](const ID<Object>& p_object)
+	{
+		return !IsObjectOverlapping(*engine.memory.objects[p_object], area, p_position, p_type, nullptr);
+	});
+	return result;
+}
+
+/*!
+	@brief Find the `Object`s that have a `Collider` covering a position.
+
+	Same as `Layer::QueryRect()` with a 1x1 rectangle.
+
+	@param position World position.
+	@param type If given, only `Collider`s of this type (`Collider::m_type`) are considered.
+
+	@return The `Object`s covering the position.
+
+	@see `Layer::QueryRect()`
+*/
+auto KTech::Layer::QueryPoint(Point p_position, std::optional<uint8_t> p_type) -> std::vector<ID<Object>>
+{
+	return QueryRect(p_position, UPoint(1, 1), p_type);
+}
+
+/*!
+	@brief Find the first `Collider` along a line.
+
+	Walks the cells of the line from `start` to `end` (both inclusive), and stops at the first cell covered by an `Object`'s `Collider`. Each step only tests the `Object`s registered in the `Layer`'s spatial hash near that cell. `ColliderGrid` cells are not included.
+
+	If multiple `Object`s cover the hit cell, the one that was added to the `Layer` first is returned.
+
+	@param start First cell of the line.
+	@param end Last cell of the line.
+	@param type If given, only `Collider`s of this type (`Collider::m_type`) are considered.
+
+	@return The hit, or `std::nullopt` if nothing was hit.
+
+	@see `Layer::QueryRect()`
+*/
+auto KTech::Layer::Raycast(Point p_start, Point p_end, std::optional<uint8_t> p_type) -> std::optional<RaycastHit>
+{
+	Collider cell;
+	cell.Simple(UPoint(1, 1), 0);
+	std::vector<ID<Object>> candidates;
+	// Bresenham's line algorithm
+	const int32_t deltaX = std::abs(p_end.x - p_start.x);
+	const int32_t deltaY = -std::abs(p_end.y - p_start.y);
+	const int32_t stepX = p_start.x < p_end.x ? 1 : -1;
+	const int32_t stepY = p_start.y < p_end.y ? 1 : -1;
+	int32_t error = deltaX + deltaY;
+	for (Point position = p_start;;)
+	{
+		candidates.clear();
+		m_spatialHash.Query(position, position + Point(1, 1), candidates);
+		for (const ID<Object>& object : candidates)
+		{
+			size_t collider;
+			if (IsObjectOverlapping(*engine.memory.objects[object], cell, position, p_type, &collider))
+			{
+				return RaycastHit{object, collider, position};
+			}
+		}
+		if (position == p_end)
+		{
+			return std::nullopt;
+		}
+		const int32_t doubleError = 2 * error;
+		if (doubleError >= deltaY)
+		{
+			error += deltaY;
+			position.x += stepX;
+		}
+		if (doubleError <= deltaX)
+		{
+			error += deltaX;
+			position.y += stepY;
+		}
+	}
+}
+
 /*!
 	@brief Virtual function called once each tick.
 
@@ -178,6 +304,8 @@ auto KTech::Layer::LeaveMap() -> bool
 
 	Called by `Memory::CallOnTicks()`.
 
+	Don't call the base `Layer::OnTick()` from your override; doing so stops this `Layer` from ticking (the base implementation unsubscribes it from `Memory::CallOnTicks()`).
+
 	@return `bool` value, which is explained in `Output::ShouldRenderThisTick()`.
 
 	@see `Memory::CallOnTicks()`
@@ -185,5 +313,50 @@ auto KTech::Layer::LeaveMap() -> bool
 */
 auto KTech::Layer::OnTick() -> bool
 {
+	engine.memory.layers.StopTicking(m_id);
+	return false;
+};
+
+// Whether any of the object's valid colliders (of the given type, if any) overlaps the given collider. Outputs the index of the first one found to `p_collider`, if not null.
+auto KTech::Layer::IsObjectOverlapping(const Object& p_object, const Collider& p_area, Point p_areaPosition, std::optional<uint8_t> p_type, size_t* p_collider) -> bool
+{
+	for (size_t i = 0; i < p_object.m_colliders.size(); i++)
+	{
+		const Collider& collider = p_object.m_colliders[i];
+		if (!collider.m_active || collider.m_size.x == 0 || collider.m_size.y == 0 || (p_type && collider.m_type != *p_type))
+		{
+			continue;
+		}
+		if (Collision::AreCollidersOverlapping(collider, p_object.m_pos + collider.m_rPos, p_area, p_areaPosition))
+		{
+			if (p_collider != nullptr)
+			{
+				*p_collider = i;
+			}
+			return true;
+		}
+	}
 	return false;
-};
\ No newline at end of file
+}
+
+// Update (or remove, if it has no valid colliders) the given object's entry in the spatial hash, according to its cached bounds. Also updates its entry in the hibernation hash, if hibernation is tracked, and records what the entries were built from (see `Object::UpdateBoundsIfStale()`).
+void KTech::Layer::UpdateSpatialHash(Object& p_object)
+{
+	p_object.m_hashedPos = p_object.m_pos;
+	p_object.m_hashedColliders = p_object.m_colliders.size();
+	Point start;
+	Point end;
+	if (p_object.GetBounds(start, end))
+	{
+		m_spatialHash.Update(p_object.m_id, start, end);
+	}
+	else
+	{
+		m_spatialHash.Remove(p_object.m_id);
+	}
+	if (engine.memory.m_trackingHibernation)
+	{
+		p_object.GetExtent(start, end);
+		m_hibernationHash.Update(p_object.m_id, start, end);
+	}
+}
\ No newline at end of file
@@ -25,9 +25,14 @@
 #undef KTECH_DEFINITION
 #include "../utility/id.hpp"
 #include "../utility/rgbacolors.hpp"
+#include "../utility/spatialhash.hpp"
+#include "../basic/point.hpp"
 #include "../basic/rgba.hpp"
+#include "../basic/upoint.hpp"
+#include "collidergrid.hpp"
 
 #include <limits>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -39,6 +44,14 @@
 class KTech::Layer
 {
 public:
+	//! @brief Result of `Layer::Raycast()`.
+	struct RaycastHit
+	{
+		ID<Object> object; //!< The hit `Object`.
+		size_t collider; //!< Index of the hit `Collider` in the `Object`'s `Object::m_colliders`.
+		Point position; //!< World position of the hit cell.
+	};
+
 	Engine& engine; //!< Parent `Engine`
 	const ID<Layer> m_id{ID<Layer>::Unique()}; //!< Personal `ID`.
 	std::string m_name; //!< String anme; could be useful in debugging.
@@ -49,6 +62,7 @@ public:
 	uint8_t m_alpha = std::numeric_limits<uint8_t>::max(); //!< Opacity used by `Camera` when rendering contained `Object`s.
 	RGBA m_frgba = RGBAColors::transparent; //!< Foreground color added by `Camera` after rendering contained `Object`s.
 	RGBA m_brgba = RGBAColors::transparent; //!< Background color added by `Camera` after rendering contained `Object`s.
+	ColliderGrid m_colliderGrid; //!< Static collision grid that contained `Object`s collide with (empty by default).
 
 	Layer(Engine& engine, std::string name = "");
 	Layer(Engine& engine, const ID<Map>& parentMap, std::string name = "");
@@ -63,8 +77,23 @@ public:
 	auto EnterMap(const ID<Map>& map) -> bool;
 	auto LeaveMap() -> bool;
 
+	auto QueryRect(Point position, UPoint size, std::optional<uint8_t> type = std::nullopt) -> std::vector<ID<Object>>;
+	auto QueryPoint(Point position, std::optional<uint8_t> type = std::nullopt) -> std::vector<ID<Object>>;
+	auto Raycast(Point start, Point end, std::optional<uint8_t> type = std::nullopt) -> std::optional<RaycastHit>;
+
 protected:
 	virtual auto OnTick() -> bool;
 
+private:
+	SpatialHash m_spatialHash;
+	SpatialHash m_hibernationHash; // Extents of all the `Object`s (see `Object::GetExtent()`), hibernating or not; only kept while `Memory` tracks hibernation
+	std::vector<ID<Object>> m_awakeObjects; // `Object`s that were in an active region at the last `Memory::UpdateHibernation()`, or entered since (may contain `Object`s that left)
+	size_t m_hibernatingObjects = 0; // Number of contained `Object`s that hibernate
+
+	static auto IsObjectOverlapping(const Object& object, const Collider& area, Point areaPosition, std::optional<uint8_t> type, size_t* collider) -> bool;
+	void UpdateSpatialHash(Object& object);
+
+	friend class KTech::Collision;
 	friend class KTech::Memory;
+	friend class KTech::Object;
 };
\ No newline at end of file
@@ -192,6 +192,8 @@ auto KTech::Map::RemoveAllCameras() -> bool
 
 	Called by `Memory::CallOnTicks()`.
 
+	Don't call the base `Map::OnTick()` from your override; doing so stops this `Map` from ticking (the base implementation unsubscribes it from `Memory::CallOnTicks()`).
+
 	@return `bool` value, which is explained in `Output::ShouldRenderThisTick()`.
 
 	@see `Memory::CallOnTicks()`
@@ -199,5 +201,6 @@ auto KTech::Map::RemoveAllCameras() -> bool
 */
 auto KTech::Map::OnTick() -> bool
 {
+	engine.memory.maps.StopTicking(m_id);
 	return false;
 };
\ No newline at end of file
@@ -23,6 +23,8 @@
 #include "layer.hpp"
 #include "../engine/engine.hpp"
 
+#include <algorithm>
+
 /*!
 	@fn Object::Object(Engine& engine, Point position, std::string name)
 	@brief Construct an `Object`.
@@ -102,11 +104,70 @@ auto KTech::Object::Move(Point p_direction) -> bool
 	return engine.collision.MoveObject(m_id, p_direction);
 }
 
+/*!
+	@fn Object::MoveSwept
+	@brief Move along a path one cell at a time, stopping at the first blocked step.
+
+	This function calls `Collision::MoveObjectSwept()` on itself. Useful for fast `Object`s (like projectiles) that shouldn't pass through thin walls.
+
+	@return How far this `Object` got.
+
+	@see `Collision::MoveObjectSwept()`
+*/
+auto KTech::Object::MoveSwept(Point p_direction) -> Point
+{
+	return engine.collision.MoveObjectSwept(m_id, p_direction);
+}
+
+/*!
+	@brief Update this `Object`'s cached bounds, and its entry in the parent `Layer`'s spatial hash.
+
+	`Collision` finds which `Object`s might collide using a spatial hash of their bounds (the rectangle enclosing their `Collider`s), kept by each `Layer`. It also rejects whole pairs of `Object`s early using their cached bounds and `Collider` types. Moving with `Object::Move()`, entering or leaving a `Layer`, and `Animation` update these automatically, and so does `Memory` after `OnTick()`, if `Object::m_pos` or the number of `Object::m_colliders` changed. Otherwise, they aren't checked for changes, so whenever you directly set `Object::m_pos` or change `Object::m_colliders` while this `Object` is in a `Layer`, call this function right after. (See the FAQ entry "When should I call `Object::UpdateBounds()`?".) The same goes for resizing or repositioning `Object::m_textures` while `Memory::hibernation` is `true`, since whether this `Object` hibernates depends on the rectangle enclosing its `Collider`s and `Texture`s.
+
+	Called from a parallel `OnTick()` (see `Object::m_parallelTick`), the update is passed to `Memory::Defer()`, because the `Layer`'s spatial hash is shared with the other threads. Until the parallel `OnTick()`s are done, other `Object`s keep seeing the previous bounds.
+
+	@see `SpatialHash`
+*/
+void KTech::Object::UpdateBounds()
+{
+	if (Memory::m_deferredCommands != nullptr)
+	{
+		// Looked up again by `ID`, in case an earlier deferred command removed this `Object`
+		engine.memory.Defer([&engine = engine, id = m_id]()
+		{
+			if (Object* object = engine.memory.objects[id])
+			{
+				object->UpdateBounds();
+			}
+		});
+		return;
+	}
+	CacheBounds();
+	if (engine.memory.layers.Exists(m_parentLayer))
+	{
+		engine.memory.layers[m_parentLayer]->UpdateSpatialHash(*this);
+	}
+}
+
+/*!
+	@brief Check whether this `Object` is hibernating.
+
+	While hibernating, this `Object` is skipped in rendering, collision and `Memory::CallOnTicks()`, as if `Object::m_active` was `false`.
+
+	@return `true` if hibernating (outside the active regions, see `Memory::hibernation`). `false` otherwise.
+*/
+auto KTech::Object::IsHibernating() const -> bool
+{
+	return m_hibernating;
+}
+
 /*!
 	@brief Virtual function called once each tick.
 
 	Called by `Memory::CallOnTicks()`.
 
+	Don't call the base `Object::OnTick()` from your override; doing so stops this `Object` from ticking, so your override would run once and never again. The base implementation is meant only for `Object`s that don't override it (usually most of them, like static scenery): it unsubscribes them from `Memory::CallOnTicks()`, so they cost nothing there.
+
 	@return `bool` value, which is explained in `Output::ShouldRenderThisTick()`.
 
 	@see `Memory::CallOnTicks()`
@@ -114,92 +175,216 @@ auto KTech::Object::Move(Point p_direction) -> bool
 */
 auto KTech::Object::OnTick() -> bool
 {
+	engine.memory.objects.StopTicking(m_id);
 	return false;
 };
 
 /*!
 	@fn KTech::Object::OnMove
-	@brief Called by `Collision::MoveObject()` as a result of this `Object` moving (voluntarily or passively).
+	@brief Called by `Collision::MoveObject()` as a result of this `Object` moving (voluntarily or passively). If `Object::m_skipUnhandledEvents` is `true`, don't call this base implementation from your override (see there).
 	@param direction The movement's direction.
 */
-void KTech::Object::OnMove(Point direction) {}
+void KTech::Object::OnMove(Point direction)
+{
+	MarkUnhandled(CollisionEvent::move);
+}
 
 /*!
 	@fn KTech::Object::OnPushed
-	@brief Called by `Collision::MoveObject()` as a result of this `Object` getting pushed.
+	@brief Called by `Collision::MoveObject()` as a result of this `Object` getting pushed. If `Object::m_skipUnhandledEvents` is `true`, don't call this base implementation from your override (see there).
 	@param direction The movement's direction.
 	@param collider The index of this `Object`'s collider that collided (`this->Object::m_colliders[collider]`).
 	@param otherObject The `Object` that collided with this `Object`.
 	@param otherCollider The index of `otherObject`'s collider that collided (`engine.memory.objects[otherObject]->Object::m_colliders[otherCollider]`).
 */
-void KTech::Object::OnPushed(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider) {}
+void KTech::Object::OnPushed(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider)
+{
+	MarkUnhandled(CollisionEvent::pushed);
+}
 
 /*!
 	@fn KTech::Object::OnPush
-	@brief Called by `Collision::MoveObject()` as a result of this `Object` pushing another `Object`.
+	@brief Called by `Collision::MoveObject()` as a result of this `Object` pushing another `Object`. If `Object::m_skipUnhandledEvents` is `true`, don't call this base implementation from your override (see there).
 	@param direction The movement's direction.
 	@param collider The index of this `Object`'s collider that collided (`this->Object::m_colliders[collider]`).
 	@param otherObject The `Object` that collided with this `Object`.
 	@param otherCollider The index of `otherObject`'s collider that collided (`engine.memory.objects[otherObject]->Object::m_colliders[otherCollider]`).
 */
-void KTech::Object::OnPush(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider) {}
+void KTech::Object::OnPush(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider)
+{
+	MarkUnhandled(CollisionEvent::push);
+}
 
 /*!
 	@fn KTech::Object::OnBlocked
-	@brief Called by `Collision::MoveObject()` as a result of this `Object` getting blocked by another `Object`.
+	@brief Called by `Collision::MoveObject()` as a result of this `Object` getting blocked by another `Object`. If `Object::m_skipUnhandledEvents` is `true`, don't call this base implementation from your override (see there).
 	@param direction The attempted movement's direction.
 	@param collider The index of this `Object`'s collider that collided (`this->Object::m_colliders[collider]`).
 	@param otherObject The `Object` that collided with this `Object`.
 	@param otherCollider The index of `otherObject`'s collider that collided (`engine.memory.objects[otherObject]->Object::m_colliders[otherCollider]`).
 */
-void KTech::Object::OnBlocked(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider) {}
+void KTech::Object::OnBlocked(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider)
+{
+	MarkUnhandled(CollisionEvent::blocked);
+}
 
 /*!
 	@fn KTech::Object::OnBlock
-	@brief Called by `Collision::MoveObject()` as a result of this `Object` blocking another `Object`.
+	@brief Called by `Collision::MoveObject()` as a result of this `Object` blocking another `Object`. If `Object::m_skipUnhandledEvents` is `true`, don't call this base implementation from your override (see there).
 	@param direction The attempted movement's direction.
 	@param collider The index of this `Object`'s collider that collided (`this->Object::m_colliders[collider]`).
 	@param otherObject The `Object` that collided with this `Object`.
 	@param otherCollider The index of `otherObject`'s collider that collided (`engine.memory.objects[otherObject]->Object::m_colliders[otherCollider]`).
 */
-void KTech::Object::OnBlock(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider) {}
+void KTech::Object::OnBlock(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider)
+{
+	MarkUnhandled(CollisionEvent::block);
+}
 
 /*!
 	@fn KTech::Object::OnOverlap
-	@brief Called by `Collision::MoveObject()` as a result of this `Object` overlapping into another `Object`.
+	@brief Called by `Collision::MoveObject()` as a result of this `Object` overlapping into another `Object`. If `Object::m_skipUnhandledEvents` is `true`, don't call this base implementation from your override (see there).
 	@param direction The movement's direction.
 	@param collider The index of this `Object`'s collider that collided (`this->Object::m_colliders[collider]`).
 	@param otherObject The `Object` that collided with this `Object`.
 	@param otherCollider The index of `otherObject`'s collider that collided (`engine.memory.objects[otherObject]->Object::m_colliders[otherCollider]`).
 */
-void KTech::Object::OnOverlap(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider) {}
+void KTech::Object::OnOverlap(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider)
+{
+	MarkUnhandled(CollisionEvent::overlap);
+}
 
 /*!
 	@fn KTech::Object::OnOverlapExit
-	@brief Called by `Collision::MoveObject()` as a result of this `Object` leaving an overlap with another `Object`.
+	@brief Called by `Collision::MoveObject()` as a result of this `Object` leaving an overlap with another `Object`. If `Object::m_skipUnhandledEvents` is `true`, don't call this base implementation from your override (see there).
 	@param direction The movement's direction.
 	@param collider The index of this `Object`'s collider that collided (`this->Object::m_colliders[collider]`).
 	@param otherObject The `Object` that collided with this `Object`.
 	@param otherCollider The index of `otherObject`'s collider that collided (`engine.memory.objects[otherObject]->Object::m_colliders[otherCollider]`).
 */
-void KTech::Object::OnOverlapExit(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider) {}
+void KTech::Object::OnOverlapExit(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider)
+{
+	MarkUnhandled(CollisionEvent::overlapExit);
+}
 
 /*!
 	@fn KTech::Object::OnOverlapped
-	@brief Called by `Collision::MoveObject()` as a result of this `Object` getting overlapped into by another `Object`.
+	@brief Called by `Collision::MoveObject()` as a result of this `Object` getting overlapped into by another `Object`. If `Object::m_skipUnhandledEvents` is `true`, don't call this base implementation from your override (see there).
 	@param direction The movement's direction.
 	@param collider The index of this `Object`'s collider that collided (`this->Object::m_colliders[collider]`).
 	@param otherObject The `Object` that collided with this `Object`.
 	@param otherCollider The index of `otherObject`'s collider that collided (`engine.memory.objects[otherObject]->Object::m_colliders[otherCollider]`).
 */
-void KTech::Object::OnOverlapped(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider) {}
+void KTech::Object::OnOverlapped(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider)
+{
+	MarkUnhandled(CollisionEvent::overlapped);
+}
 
 /*!
 	@fn KTech::Object::OnOverlappedExit
-	@brief Called by `Collision::MoveObject()` as a result of **another** `Object` leaving an overlap with **this** `Object`.
+	@brief Called by `Collision::MoveObject()` as a result of **another** `Object` leaving an overlap with **this** `Object`. If `Object::m_skipUnhandledEvents` is `true`, don't call this base implementation from your override (see there).
 	@param direction The movement's direction.
 	@param collider The index of this `Object`'s collider that collided (`this->Object::m_colliders[collider]`).
 	@param otherObject The `Object` that collided with this `Object`.
 	@param otherCollider The index of `otherObject`'s collider that collided (`engine.memory.objects[otherObject]->Object::m_colliders[otherCollider]`).
 */
-void KTech::Object::OnOverlappedExit(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider) {}
\ No newline at end of file
+void KTech::Object::OnOverlappedExit(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider)
+{
+	MarkUnhandled(CollisionEvent::overlappedExit);
+}
+
+// Called by the default implementations of the collision callbacks, which means they weren't overridden (unless an override called them, which `m_skipUnhandledEvents` rules out).
+void KTech::Object::MarkUnhandled(CollisionEvent p_event)
+{
+	if (m_skipUnhandledEvents)
+	{
+		m_unhandledEvents |= static_cast<uint16_t>(p_event);
+	}
+}
+
+// Whether the callback of a collision event should be called (it is overridden, not yet known not to be, or skipping is disabled).
+auto KTech::Object::IsHandled(CollisionEvent p_event) const -> bool
+{
+	return !m_skipUnhandledEvents || (m_unhandledEvents & static_cast<uint16_t>(p_event)) == 0;
+}
+
+// Calculate the rectangle enclosing all valid `Collider`s and the mask of their types. An inactive or hibernating object has no valid `Collider`s.
+void KTech::Object::CacheBounds()
+{
+	m_colliderTypesMask = 0;
+	for (const Collider& collider : m_colliders)
+	{
+		if (!m_active || m_hibernating || !collider.m_active || collider.m_size.x == 0 || collider.m_size.y == 0)
+		{
+			continue;
+		}
+		const Point end = collider.m_rPos + collider.m_size;
+		if (m_colliderTypesMask == 0)
+		{
+			m_boundsStart = collider.m_rPos;
+			m_boundsEnd = end;
+		}
+		else
+		{
+			m_boundsStart = Point(std::min(m_boundsStart.x, collider.m_rPos.x), std::min(m_boundsStart.y, collider.m_rPos.y));
+			m_boundsEnd = Point(std::max(m_boundsEnd.x, end.x), std::max(m_boundsEnd.y, end.y));
+		}
+		m_colliderTypesMask |= uint64_t{1} << std::min<uint8_t>(collider.m_type, 63);
+	}
+}
+
+// Get the world-space rectangle enclosing all valid `Collider`s, as cached by `CacheBounds()`.
+// Returns false if there are no valid `Collider`s (`start` and `end` are obsolete).
+auto KTech::Object::GetBounds(Point& p_start, Point& p_end) const -> bool
+{
+	p_start = m_pos + m_boundsStart;
+	p_end = m_pos + m_boundsEnd;
+	return m_colliderTypesMask != 0;
+}
+
+// Get the world-space rectangle enclosing all `Collider`s and `Texture`s, whether active or not (so hiding and showing them doesn't change it), or the cell at `m_pos` if there are none. Used for hibernation.
+void KTech::Object::GetExtent(Point& p_start, Point& p_end) const
+{
+	bool found = false;
+	auto include = [&](Point p_rPos, UPoint p_size)
+	{
+		if (p_size.x == 0 || p_size.y == 0)
+		{
+			return;
+		}
+		const Point end = p_rPos + p_size;
+		if (!found)
+		{
+			p_start = p_rPos;
+			p_end = end;
+			found = true;
+			return;
+		}
+		p_start = Point(std::min(p_start.x, p_rPos.x), std::min(p_start.y, p_rPos.y));
+		p_end = Point(std::max(p_end.x, end.x), std::max(p_end.y, end.y));
+	};
+	for (const Collider& collider : m_colliders)
+	{
+		include(collider.m_rPos, collider.m_size);
+	}
+	for (const Texture& texture : m_textures)
+	{
+		include(texture.m_rPos, texture.m_size);
+	}
+	if (!found)
+	{
+		p_start = Point(0, 0);
+		p_end = Point(1, 1);
+	}
+	p_start = m_pos + p_start;
+	p_end = m_pos + p_end;
+}
+
+// Update the bounds if `m_pos` or the size of `m_colliders` differ from what the spatial hash entry was built from, i.e., were changed directly without `UpdateBounds()`. Called by `Memory` after `OnTick()`.
+void KTech::Object::UpdateBoundsIfStale()
+{
+	if (m_parentLayer != nullID<Layer> && (m_pos != m_hashedPos || m_colliders.size() != m_hashedColliders))
+	{
+		UpdateBounds();
+	}
+}
\ No newline at end of file
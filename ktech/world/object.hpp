@@ -41,9 +41,12 @@ public:
 	std::string m_name; //!< String name.
 	ID<Layer> m_parentLayer; //!< Parent `Layer`.
 
-	Point m_pos; //!< World position.
-	std::vector<Texture> m_textures = {}; //!< `Texture`s.
-	std::vector<Collider> m_colliders = {}; //!< `Collider`s.
+	Point m_pos; //!< World position. If you set it directly (rather than with `Object::Move()`) while in a `Layer`, call `Object::UpdateBounds()` afterwards, or other `Object`s will collide with this `Object` at its previous position.
+	std::vector<Texture> m_textures = {}; //!< `Texture`s. If you resize or reposition them while in a `Layer` and `Memory::hibernation` is `true`, call `Object::UpdateBounds()` afterwards, or this `Object` may hibernate while they are in view.
+	std::vector<Collider> m_colliders = {}; //!< `Collider`s. If you change them while in a `Layer` (including in the constructor, after entering the `Layer`), call `Object::UpdateBounds()` afterwards, or other `Object`s will collide with the previous ones.
+	bool m_parallelTick = false; //!< `true`: `OnTick()` is thread-safe, so `Memory::CallOnTicks()` may call it on a worker thread (see `Memory::Defer()`). It may only change this `Object`, and should look other structures up with the const `CachingRegistry` lookups (e.g., `std::as_const(engine.memory.objects)[id]`), which don't write to the shared `ID` caches. This also changes when it's called: after the `OnTick()`s of all the `Object`s that aren't parallel, rather than in the order the `Object`s were created in. `false` (default): it's always called on the calling thread, in creation order.
+	bool m_skipUnhandledEvents = false; //!< `true`: collision callbacks (like `Object::OnPush()`) that this `Object` doesn't override are skipped after their first call, which saves calling (or queuing) them for crowds of `Object`s. Don't set it if any of your overrides calls the base `Object` implementation, because that marks the override as not overridden, and it stops being called. `false` (default): all collision callbacks are called.
+	bool m_active = true; //!< Activation status: `true` means enabled. `false` means disabled: skipped in rendering, collision and `Memory::CallOnTicks()`, while staying in the parent `Layer` (see `ObjectPool`).
 
 	Object(Engine& engine, Point position = Point(0, 0), std::string name = "");
 	Object(Engine& engine, const ID<Layer>& parentLayer, Point position = Point(0, 0), std::string name = "");
@@ -53,6 +56,10 @@ public:
 	auto LeaveLayer() -> bool;
 
 	auto Move(Point direction) -> bool;
+	auto MoveSwept(Point direction) -> Point;
+
+	void UpdateBounds();
+	[[nodiscard]] auto IsHibernating() const -> bool;
 
 protected:
 	virtual auto OnTick() -> bool;
@@ -66,6 +73,38 @@ protected:
 	virtual void OnOverlapped(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider);
 	virtual void OnOverlappedExit(Point direction, size_t collider, ID<Object> otherObject, size_t otherCollider);
 
+private:
+	// Collision events, as bits of `m_unhandledEvents`
+	enum class CollisionEvent : uint16_t
+	{
+		move = 1 << 0,
+		pushed = 1 << 1,
+		push = 1 << 2,
+		blocked = 1 << 3,
+		block = 1 << 4,
+		overlap = 1 << 5,
+		overlapExit = 1 << 6,
+		overlapped = 1 << 7,
+		overlappedExit = 1 << 8
+	};
+
+	bool m_hibernating = false; // Set by `Memory` while outside the active regions; has the same effect as `m_active == false`
+	uint16_t m_unhandledEvents = 0; // Collision events whose callbacks weren't overridden (their default implementations mark them here, if `m_skipUnhandledEvents` is `true`), so `Collision` can skip them
+	Point m_boundsStart; // Cached rectangle enclosing the valid colliders, relative to `m_pos`
+	Point m_boundsEnd; // ^ (exclusive)
+	uint64_t m_colliderTypesMask = 0; // Cached bit per type of the valid colliders (types from 63 and on share the last bit). 0 means there are no valid colliders.
+	size_t m_hibernationUpdate = 0; // Last `Memory::UpdateHibernation()` call that found this `Object` in an active region
+	Point m_hashedPos; // `m_pos` when this `Object`'s entry in its `Layer`'s spatial hash was last updated
+	size_t m_hashedColliders = 0; // Size of `m_colliders` ^
+
+	void MarkUnhandled(CollisionEvent event);
+	[[nodiscard]] auto IsHandled(CollisionEvent event) const -> bool;
+	void CacheBounds();
+	auto GetBounds(Point& start, Point& end) const -> bool;
+	void GetExtent(Point& start, Point& end) const;
+	void UpdateBoundsIfStale();
+
 	friend class KTech::Collision;
+	friend class KTech::Layer;
 	friend class KTech::Memory;
 };
\ No newline at end of file
@@ -131,6 +131,7 @@ void KTech::UI::Resize(UPoint p_resolution)
 */
 void KTech::UI::Render()
 {
+	const Profiler::Scope profilerScope(engine.profiler, Profiler::Phase::uiRender);
 	RenderBackground();
 
 	for (ID<Widget>& widgetID : m_widgets)
@@ -210,6 +211,8 @@ void KTech::UI::RenderClearDrawPrint()
 
 	Called by `Memory::CallOnTicks()`.
 
+	Don't call the base `UI::OnTick()` from your override; doing so stops this `UI` from ticking (the base implementation unsubscribes it from `Memory::CallOnTicks()`).
+
 	@return `bool` value, which is explained in `Output::ShouldRenderThisTick()`.
 
 	@see `Memory::CallOnTicks()`
@@ -217,6 +220,7 @@ void KTech::UI::RenderClearDrawPrint()
 */
 auto KTech::UI::OnTick() -> bool
 {
+	engine.memory.uis.StopTicking(m_id);
 	return false;
 };
 
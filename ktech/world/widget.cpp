@@ -266,6 +266,8 @@ void KTech::Widget::Hide()
 
 	Called by `Memory::CallOnTicks()`.
 
+	Don't call the base `Widget::OnTick()` from your override; doing so stops this `Widget` from ticking (the base implementation unsubscribes it from `Memory::CallOnTicks()`).
+
 	@return `bool` value, which is explained in `Output::ShouldRenderThisTick()`.
 
 	@see `Memory::CallOnTicks()`
@@ -273,6 +275,7 @@ void KTech::Widget::Hide()
 */
 auto KTech::Widget::OnTick() -> bool
 {
+	engine.memory.widgets.StopTicking(m_id);
 	return false;
 };
 